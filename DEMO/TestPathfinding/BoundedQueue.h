@@ -0,0 +1,141 @@
+#pragma once
+
+#include "Define.h"
+
+namespace BT
+{
+    //----------------------------------------------------------------------------
+    /// \brief Bounded lock-free queue for many producers and many consumers.
+    /// Ring of cells where each cell has a sequence number: producer waits for
+    /// sequence == position, consumer for sequence == position + 1, so one
+    /// compare-and-swap on shared index is enough by operation.
+    /// \code{ .cpp }
+    ///     BT::BoundedQueue<std::unique_ptr<Job>> queue(1024);
+    ///     if(!queue.tryPush(std::move(job))) { /* full */ }
+    ///     std::unique_ptr<Job> job;
+    ///     while(queue.tryPop(job)) { execute(*job); }
+    /// \endcode
+    template<typename DataType>
+    class BoundedQueue final
+    {
+        BT_NOCOPY_NOMOVE(BoundedQueue);
+
+        public:
+            //------------------------------------------------------------------------
+            /// \brief  Constructor: allocate all cells.
+            ///
+            /// \param[in] capacity: minimum number of items (rounded to power of 2).
+            explicit BoundedQueue(const size_t capacity):
+            _enqueue(0), _dequeue(0)
+            {
+                BT_PRE_CONDITION(capacity > 0);     // DEV Issue: Empty queue !
+
+                size_t size = 1;
+                while(size < capacity)
+                {
+                    size *= 2;
+                }
+                _cells = std::make_unique<Cell[]>(size);
+                _mask  = size - 1;
+                for(size_t position = 0; position < size; ++position)
+                {
+                    _cells[position]._sequence.store(position, std::memory_order_relaxed);
+                }
+            }
+
+            /// Destructor
+            ~BoundedQueue() = default;
+
+            size_t getCapacity() const
+            {
+                return _mask + 1;
+            }
+
+            //------------------------------------------------------------------------
+            /// \brief  Add item at end of queue (never blocks).
+            ///
+            /// \param[in,out] data: item moved into queue only if there is room.
+            /// \returns True if added, false if queue is full.
+            bool tryPush(DataType&& data)
+            {
+                size_t position = _enqueue.load(std::memory_order_relaxed);
+                Cell* cell = nullptr;
+                while(true)
+                {
+                    cell = &_cells[position & _mask];
+                    const size_t   sequence   = cell->_sequence.load(std::memory_order_acquire);
+                    const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                    if(difference == 0)
+                    {
+                        if(_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else if(difference < 0)
+                    {
+                        // Cell not yet read by consumer of previous lap
+                        return false;
+                    }
+                    else
+                    {
+                        position = _enqueue.load(std::memory_order_relaxed);
+                    }
+                }
+
+                cell->_data = std::move(data);
+                cell->_sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+
+            //------------------------------------------------------------------------
+            /// \brief  Take item at front of queue (never blocks).
+            ///
+            /// \param[out] data: oldest item (only if found).
+            /// \returns True if one item was read, false if queue is empty.
+            bool tryPop(DataType& data)
+            {
+                size_t position = _dequeue.load(std::memory_order_relaxed);
+                Cell* cell = nullptr;
+                while(true)
+                {
+                    cell = &_cells[position & _mask];
+                    const size_t   sequence   = cell->_sequence.load(std::memory_order_acquire);
+                    const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+                    if(difference == 0)
+                    {
+                        if(_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else if(difference < 0)
+                    {
+                        // Cell not yet written by producer
+                        return false;
+                    }
+                    else
+                    {
+                        position = _dequeue.load(std::memory_order_relaxed);
+                    }
+                }
+
+                data = std::move(cell->_data);
+                // Ready for producer of next lap
+                cell->_sequence.store(position + _mask + 1, std::memory_order_release);
+                return true;
+            }
+
+        private:
+            //----------------------------------------------------------------------------
+            /// \brief Slot of ring.
+            struct Cell
+            {
+                std::atomic<size_t> _sequence;  ///< Position allowed to use this cell.
+                DataType            _data;      ///< Stored item.
+            };
+
+            std::unique_ptr<Cell[]> _cells;         ///< [OWNERSHIP] Ring of cells.
+            size_t                  _mask;          ///< Number of cells - 1.
+            char                    _padding0[64];  ///< Producers and consumers never share cache line.
+            std::atomic<size_t>     _enqueue;       ///< Next position to write.
+            char                    _padding1[64];  ///< Producers and consumers never share cache line.
+            std::atomic<size_t>     _dequeue;       ///< Next position to read.
+    };
+}
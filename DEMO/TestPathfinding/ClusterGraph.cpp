@@ -0,0 +1,324 @@
+#include "ClusterGraph.h"
+
+const ClusterGraph::NodeID     ClusterGraph::_noNode;
+const BT::uint32               ClusterGraph::_noPortal;
+
+void ClusterGraph::build(const PathWorld& world, const Agent::Navigation& navigation, const size_t nodesByCluster, bool speedMode)
+{
+    BT_PRE_CONDITION(isNull());             // DEV Issue: build() already called !
+    BT_PRE_CONDITION(!world.isNull());      // DEV Issue: World not initialized !
+    BT_PRE_CONDITION(nodesByCluster > 0);   // DEV Issue: Need one node by cluster at least !
+
+    const TerrainGraph& graph = world.getGraph();
+    const NodeID nbNodes = static_cast<NodeID>(graph.getNbNodes());
+
+    _world     = &world;
+    _agent     = std::make_unique<Agent>(navigation);
+    _speedMode = speedMode;
+    _overlay   = world.getOverlay();
+    _overlayVersion = _overlay ? _overlay->getVersion() : 0;
+
+    // Grid cell side: nodesByCluster centroids by cell (mean)
+    BoostBox bounds;
+    bg::assign_inverse(bounds);
+    for(NodeID node = 0; node < nbNodes; ++node)
+    {
+        bg::expand(bounds, graph.getCentroid(node));
+    }
+    const float width  = std::max(bounds.max_corner().get<0>() - bounds.min_corner().get<0>(), 1.0f);
+    const float height = std::max(bounds.max_corner().get<1>() - bounds.min_corner().get<1>(), 1.0f);
+    const float side   = std::sqrt(width * height * static_cast<float>(nodesByCluster) / static_cast<float>(nbNodes));
+    const auto getCell = [&](const NodeID node)
+    {
+        const BoostPoint& centroid = graph.getCentroid(node);
+        return std::make_pair(static_cast<int>((centroid.get<0>() - bounds.min_corner().get<0>()) / side),
+                              static_cast<int>((centroid.get<1>() - bounds.min_corner().get<1>()) / side));
+    };
+
+    // Cluster = connected nodes of same cell (so best path inside cluster always exists): blocked edge never links
+    const auto isOpen = [&](const NodeID node, const TerrainGraph::EdgeID edge)
+    {
+        return getWeight(node, edge) != std::numeric_limits<CostType>::infinity() && getWeight(graph.getTarget(edge), graph.getReverseEdge(edge)) != std::numeric_limits<CostType>::infinity();
+    };
+    _clusters.assign(nbNodes, std::numeric_limits<ClusterID>::max());
+    _nbClusters = 0;
+    std::vector<NodeID> stack;
+    for(NodeID seed = 0; seed < nbNodes; ++seed)
+    {
+        if(_clusters[seed] != std::numeric_limits<ClusterID>::max())
+            continue;
+
+        const auto cell = getCell(seed);
+        const ClusterID cluster = static_cast<ClusterID>(_nbClusters++);
+        _clusters[seed] = cluster;
+        stack.push_back(seed);
+        while(!stack.empty())
+        {
+            const NodeID node = stack.back();
+            stack.pop_back();
+            for(TerrainGraph::EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+            {
+                const NodeID next = graph.getTarget(edge);
+                if(_clusters[next] == std::numeric_limits<ClusterID>::max() && getCell(next) == cell && isOpen(node, edge))
+                {
+                    _clusters[next] = cluster;
+                    stack.push_back(next);
+                }
+            }
+        }
+    }
+
+    // Portals grouped by cluster
+    _portalIDs.assign(nbNodes, _noPortal);
+    _clusterPortals.assign(_nbClusters + 1, 0);
+    for(NodeID node = 0; node < nbNodes; ++node)
+    {
+        for(TerrainGraph::EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+        {
+            if(_clusters[graph.getTarget(edge)] != _clusters[node])
+            {
+                _portalIDs[node] = 0;
+                ++_clusterPortals[_clusters[node] + 1];
+                break;
+            }
+        }
+    }
+    for(size_t cluster = 0; cluster < _nbClusters; ++cluster)
+    {
+        _clusterPortals[cluster + 1] += _clusterPortals[cluster];
+    }
+    _portals.resize(_clusterPortals.back());
+    {
+        std::vector<BT::uint32> next(_clusterPortals.begin(), _clusterPortals.end() - 1);
+        for(NodeID node = 0; node < nbNodes; ++node)
+        {
+            if(_portalIDs[node] == _noPortal)
+                continue;
+            _portalIDs[node] = next[_clusters[node]]++;
+            _portals[_portalIDs[node]] = node;
+        }
+    }
+
+    // Heuristic factor: lowest weight by distance between centroids
+    _minCostByDistance = std::numeric_limits<CostType>::infinity();
+    for(NodeID node = 0; node < nbNodes; ++node)
+    {
+        for(TerrainGraph::EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+        {
+            const float distance = static_cast<float>(bg::distance(graph.getCentroid(node), graph.getCentroid(graph.getTarget(edge))));
+            if(distance > 0.0f)
+                _minCostByDistance = std::min(_minCostByDistance, getWeight(node, edge) / distance);
+        }
+    }
+    if(_minCostByDistance == std::numeric_limits<CostType>::infinity())
+        _minCostByDistance = 0.0f;
+
+    // Abstract arcs: best path to other portals of cluster then edges to neighbor clusters
+    PathSearchContext context;
+    std::vector<ClusterID> corridor(1);
+    _offsets.assign(_portals.size() + 1, 0);
+    _arcs.clear();
+    for(BT::uint32 portal = 0; portal < _portals.size(); ++portal)
+    {
+        const NodeID node = _portals[portal];
+        const ClusterID cluster = _clusters[node];
+
+        corridor[0] = cluster;
+        searchInside(node, _noNode, corridor, false, context);
+        for(BT::uint32 other = _clusterPortals[cluster]; other < _clusterPortals[cluster + 1]; ++other)
+        {
+            if(other != portal && context.isReached(_portals[other]))
+                _arcs.push_back({ other, context.getCost(_portals[other]) });
+        }
+
+        for(TerrainGraph::EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+        {
+            const NodeID next = graph.getTarget(edge);
+            if(_clusters[next] != cluster)
+            {
+                BT_ASSERT(_portalIDs[next] != _noPortal);   // DEV Issue: Graph must be symmetric !
+                if(getWeight(node, edge) != std::numeric_limits<CostType>::infinity())
+                    _arcs.push_back({ _portalIDs[next], getWeight(node, edge) });
+            }
+        }
+        _offsets[portal + 1] = static_cast<BT::uint32>(_arcs.size());
+    }
+    _arcs.shrink_to_fit();
+
+    BT_POST_CONDITION(!isNull());
+}
+
+void ClusterGraph::release()
+{
+    BT_PRE_CONDITION(!isNull());    // DEV Issue: Need to call build before
+
+    _world       = nullptr;
+    _agent.reset();
+    _overlay.reset();
+    _overlayVersion = 0;
+    _nbClusters  = 0;
+    _minCostByDistance = 0.0f;
+    _clusters       = std::vector<ClusterID>();
+    _portalIDs      = std::vector<BT::uint32>();
+    _portals        = std::vector<NodeID>();
+    _clusterPortals = std::vector<BT::uint32>();
+    _offsets        = std::vector<BT::uint32>();
+    _arcs           = std::vector<Arc>();
+
+    BT_POST_CONDITION(isNull());
+}
+
+ClusterGraph::CostType ClusterGraph::getWeight(const NodeID from, const TerrainGraph::EdgeID edge) const
+{
+    if(_overlay)
+        return _speedMode ? _world->updateSpeedWeight(edge, *_overlay) : _world->updateWeight(*_agent, from, edge, *_overlay);
+    return _speedMode ? _world->updateSpeedWeight(edge) : _world->updateWeight(*_agent, from, edge);
+}
+
+BT::uint32 ClusterGraph::searchInside(const NodeID from, const NodeID to, const std::vector<ClusterID>& corridor, const bool reverse, PathSearchContext& context) const
+{
+    BT_PRE_CONDITION(to == _noNode || !reverse);    // DEV Issue: Goal search is forward only !
+
+    const TerrainGraph& graph = _world->getGraph();
+    const BoostPoint& goal = graph.getCentroid(to == _noNode ? from : to);
+    const auto heuristic = [&](const NodeID node)
+    {
+        return to == _noNode ? 0.0f : estimate(node, goal);
+    };
+
+    context.prepare(graph.getNbNodes());
+    context.reach(from, 0.0f, from);
+    context.push(from, 0.0f, heuristic(from));
+
+    BT::uint32 nbExpansions = 0;
+    while(!context.isOpenEmpty())
+    {
+        const PathSearchContext::OpenNode current = context.pop();
+        if(context.getCost(current._node) < current._cost)
+            continue;
+        ++nbExpansions;
+        if(current._node == to)
+            break;
+
+        for(TerrainGraph::EdgeID edge = graph.beginEdge(current._node); edge != graph.endEdge(current._node); ++edge)
+        {
+            const NodeID next = graph.getTarget(edge);
+            if(!std::binary_search(corridor.begin(), corridor.end(), _clusters[next]))
+                continue;
+
+            const CostType cost = current._cost + (reverse ? getWeight(next, graph.getReverseEdge(edge)) : getWeight(current._node, edge));
+            if(cost < context.getCost(next))
+            {
+                context.reach(next, cost, current._node);
+                context.push(next, cost, cost + heuristic(next));
+            }
+        }
+    }
+    return nbExpansions;
+}
+
+ClusterGraph::SearchResult ClusterGraph::computePath(const NodeID from, const NodeID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const
+{
+    BT_PRE_CONDITION(!isNull());                    // DEV Issue: Need to call build before
+    BT_PRE_CONDITION(from < _clusters.size());      // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(to   < _clusters.size());      // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(pathWay.empty());              // DEV Issue: Need an empty result!
+    BT_PRE_CONDITION(isUpToDate());                 // DEV Issue: Overlay changed: rebuild clusters !
+
+    SearchResult result{ false, 0, 0.0f };
+
+    // Parse only if inside same sub-graph (else never solution so don't waste time)
+    const TerrainGraph& graph = _world->getGraph();
+    if(graph.getSubgraphID(from) != graph.getSubgraphID(to))
+        return result;
+
+    const ClusterID fromCluster = _clusters[from];
+    const ClusterID toCluster   = _clusters[to];
+    const BT::uint32 fromPortal = _clusterPortals[fromCluster];
+    const BT::uint32 toPortal   = _clusterPortals[toCluster];
+
+    // Connect start to portals of its cluster (and goal when inside)
+    std::vector<ClusterID> corridor(1, fromCluster);
+    result._nbExpansions += searchInside(from, _noNode, corridor, false, context);
+    std::vector<CostType> startCosts(_clusterPortals[fromCluster + 1] - fromPortal);
+    for(BT::uint32 portal = fromPortal; portal < _clusterPortals[fromCluster + 1]; ++portal)
+    {
+        startCosts[portal - fromPortal] = context.getCost(_portals[portal]);
+    }
+    const CostType directCost = fromCluster == toCluster ? context.getCost(to) : std::numeric_limits<CostType>::infinity();
+
+    // Connect portals of goal cluster to goal
+    corridor[0] = toCluster;
+    result._nbExpansions += searchInside(to, _noNode, corridor, true, context);
+    std::vector<CostType> goalCosts(_clusterPortals[toCluster + 1] - toPortal);
+    for(BT::uint32 portal = toPortal; portal < _clusterPortals[toCluster + 1]; ++portal)
+    {
+        goalCosts[portal - toPortal] = context.getCost(_portals[portal]);
+    }
+
+    // Abstract A*: portals then start and goal
+    const BT::uint32 start = static_cast<BT::uint32>(_portals.size());
+    const BT::uint32 goal  = start + 1;
+    const BoostPoint& goalPoint = graph.getCentroid(to);
+
+    PathSearchContext& abstract = context.getReverse();
+    abstract.prepare(_portals.size() + 2);
+    abstract.reach(start, 0.0f, start);
+    abstract.push(start, 0.0f, 0.0f);
+    const auto relax = [&](const BT::uint32 portal, const BT::uint32 next, const CostType cost)
+    {
+        if(cost < abstract.getCost(next))
+        {
+            abstract.reach(next, cost, portal);
+            abstract.push(next, cost, cost + (next == goal ? 0.0f : estimate(_portals[next], goalPoint)));
+        }
+    };
+
+    while(!abstract.isOpenEmpty())
+    {
+        const PathSearchContext::OpenNode current = abstract.pop();
+        if(abstract.getCost(current._node) < current._cost)
+            continue;
+        ++result._nbExpansions;
+        if(current._node == goal)
+            break;
+
+        if(current._node == start)
+        {
+            for(BT::uint32 portal = 0; portal < startCosts.size(); ++portal)
+                relax(start, fromPortal + portal, startCosts[portal]);
+            relax(start, goal, directCost);
+            continue;
+        }
+
+        for(BT::uint32 arcID = _offsets[current._node]; arcID != _offsets[current._node + 1]; ++arcID)
+        {
+            relax(current._node, _arcs[arcID]._portal, current._cost + _arcs[arcID]._weight);
+        }
+        if(_clusters[_portals[current._node]] == toCluster)
+        {
+            relax(current._node, goal, current._cost + goalCosts[current._node - toPortal]);
+        }
+    }
+
+    if(!abstract.isReached(goal))
+        return result;
+
+    // Corridor: clusters of abstract path
+    corridor.assign({ fromCluster, toCluster });
+    for(BT::uint32 portal = abstract.getPredecessor(goal); portal != start; portal = abstract.getPredecessor(portal))
+    {
+        corridor.push_back(_clusters[_portals[portal]]);
+    }
+    std::sort(corridor.begin(), corridor.end());
+    corridor.erase(std::unique(corridor.begin(), corridor.end()), corridor.end());
+
+    // Refine: abstract path stays inside corridor so goal is always reached
+    result._nbExpansions += searchInside(from, to, corridor, false, context);
+    BT_ASSERT(context.isReached(to));   // DEV Issue: Abstract graph is corrupted !
+
+    result._found = true;
+    result._cost  = context.getCost(to);
+    _world->extractPath(to, context, pathWay);
+    return result;
+}
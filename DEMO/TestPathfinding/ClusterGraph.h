@@ -0,0 +1,174 @@
+#pragma once
+
+#include "PathWorld.h"
+
+//----------------------------------------------------------------------------
+/// \brief Two-level hierarchy of PathWorld graph (HPA*) for one agent profile.
+/// WalkTerrain are grouped by grid cell into connected clusters. Nodes with an
+/// edge to another cluster are portals: the abstract graph links portals of
+/// same cluster (cost of best path inside cluster) and portals of neighbor
+/// clusters (original edge). Query searches abstract graph, then refines with
+/// A* only inside clusters crossed by abstract path (corridor).
+/// \code{ .cpp }
+///     ClusterGraph clusters;
+///     clusters.build(world, agent.getNavigation(), 256);
+///     world.computePath(clusters, from, to, pathWay, context);
+/// \endcode
+/// \note Abstract costs are exact so refined path is optimal.
+class ClusterGraph final
+{
+    BT_NOCOPY_NOMOVE(ClusterGraph);
+
+    public:
+        using NodeID       = PathWorld::WalkTerrainID;
+        using ClusterID    = BT::uint32;
+        using CostType     = PathWorld::CostType;
+        using SearchResult = PathWorld::SearchResult;
+
+        /// Constructor
+        ClusterGraph():
+        _world(nullptr), _nbClusters(0), _minCostByDistance(0.0f), _overlayVersion(0)
+        {}
+
+        /// Destructor
+        ~ClusterGraph()
+        {
+            BT_POST_CONDITION(isNull());    // DEV Issue: Call release() !
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Build clusters, portals and abstract graph using weight of profile (with current overlay: rebuild after overrides).
+        ///
+        /// \param[in] world: initialized world (must live longer than hierarchy).
+        /// \param[in] navigation: agent profile (speed by terrain).
+        /// \param[in] nodesByCluster: mean number of nodes by grid cell.
+        /// \param[in] speedMode: use only distance as weight (navigation is ignored).
+        void build(const PathWorld& world, const Agent::Navigation& navigation, const size_t nodesByCluster, bool speedMode = false);
+
+        //------------------------------------------------------------------------
+        /// \brief  Release all data.
+        ///
+        void release();
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if hierarchy is built.
+        ///
+        /// \returns True if null, false otherwise.
+        bool isNull() const
+        {
+            return _world == nullptr;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get world used to build hierarchy.
+        ///
+        /// \returns World.
+        const PathWorld& getWorld() const
+        {
+            BT_PRE_CONDITION(!isNull());
+            return *_world;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if clusters were built with current overlay of world.
+        ///
+        /// \returns True if up to date, false if overlay changed since build().
+        bool isUpToDate() const
+        {
+            BT_PRE_CONDITION(!isNull());
+            return _overlayVersion == _world->getOverlayVersion();
+        }
+
+        size_t getNbClusters() const
+        {
+            return _nbClusters;
+        }
+
+        size_t getNbPortals() const
+        {
+            return _portals.size();
+        }
+
+        size_t getNbAbstractArcs() const
+        {
+            return _arcs.size();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get cluster of node.
+        ///
+        /// \param[in] node: node of world graph.
+        /// \returns Cluster ID.
+        ClusterID getCluster(const NodeID node) const
+        {
+            BT_PRE_CONDITION(node < _clusters.size());
+            return _clusters[node];
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Search abstract graph then refine inside corridor.
+        ///
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] pathWay: centroid of each node from goal to start.
+        /// \param[in,out] context: workspace of current thread (reverse side holds abstract search).
+        /// \returns Goal found, number of examined nodes (both levels) and cost of path.
+        SearchResult computePath(const NodeID from, const NodeID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const;
+
+    private:
+        //----------------------------------------------------------------------------
+        /// \brief Arc of abstract graph.
+        struct Arc
+        {
+            BT::uint32  _portal;    ///< Target portal.
+            CostType    _weight;    ///< Cost of best path.
+        };
+
+        //------------------------------------------------------------------------
+        /// \brief  Weight of edge for profile.
+        ///
+        /// \param[in] from: source node of edge.
+        /// \param[in] edge: out edge of from.
+        /// \returns Weight of edge.
+        CostType getWeight(const NodeID from, const TerrainGraph::EdgeID edge) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Admissible estimation between two points (never greater than real cost).
+        ///
+        /// \param[in] node: current node.
+        /// \param[in] goal: goal point.
+        /// \returns Lower bound of cost.
+        CostType estimate(const NodeID node, const BoostPoint& goal) const
+        {
+            return _minCostByDistance * static_cast<CostType>(bg::distance(_world->getGraph().getCentroid(node), goal));
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  A* (or Dijkstra without goal) using only nodes of sorted clusters.
+        ///
+        /// \param[in] from: source.
+        /// \param[in] to: goal (stop when reached) or _noNode to settle all nodes.
+        /// \param[in] corridor: sorted allowed clusters.
+        /// \param[in] reverse: follow edges backward (without goal only).
+        /// \param[in,out] context: workspace where cost/predecessor are written.
+        /// \returns Number of examined nodes.
+        BT::uint32 searchInside(const NodeID from, const NodeID to, const std::vector<ClusterID>& corridor, const bool reverse, PathSearchContext& context) const;
+
+        static const NodeID     _noNode   = std::numeric_limits<NodeID>::max();      ///< No goal marker.
+        static const BT::uint32 _noPortal = std::numeric_limits<BT::uint32>::max();  ///< Node is not portal.
+
+        const PathWorld*            _world;             ///< [LINK] Source world. WARNING: No destruction.
+        std::unique_ptr<Agent>      _agent;             ///< [OWNERSHIP] Profile used for weight.
+        std::shared_ptr<const CostOverlay> _overlay;    ///< [OWNERSHIP] Snapshot used by build() and refinement (null if none).
+        CostOverlay::Version        _overlayVersion;    ///< Version of snapshot.
+        bool                        _speedMode;         ///< Distance only weight.
+        size_t                      _nbClusters;        ///< Number of clusters.
+        CostType                    _minCostByDistance; ///< Lowest weight by unit of distance (heuristic factor).
+
+        std::vector<ClusterID>      _clusters;          ///< [OWNERSHIP] Cluster of each node.
+        std::vector<BT::uint32>     _portalIDs;         ///< [OWNERSHIP] Portal of each node (_noPortal if inside).
+        std::vector<NodeID>         _portals;           ///< [OWNERSHIP] Node of each portal (sorted by cluster).
+        std::vector<BT::uint32>     _clusterPortals;    ///< [OWNERSHIP] First portal of each cluster (size = clusters + 1).
+        std::vector<BT::uint32>     _offsets;           ///< [OWNERSHIP] First arc of each portal (size = portals + 1).
+        std::vector<Arc>            _arcs;              ///< [OWNERSHIP] Abstract arcs sorted by source portal.
+};
@@ -0,0 +1,523 @@
+#include "ContractionHierarchy.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    using NodeID   = ContractionHierarchy::NodeID;
+    using CostType = ContractionHierarchy::CostType;
+
+    //----------------------------------------------------------------------------
+    /// \brief Dynamic graph used while nodes are contracted.
+    class Contractor
+    {
+        public:
+            //----------------------------------------------------------------------------
+            /// \brief Arc during build.
+            struct BuildArc
+            {
+                NodeID      _node;      ///< Other extremity.
+                CostType    _weight;    ///< Cost of arc.
+                NodeID      _middle;    ///< Bypassed node.
+            };
+
+            //----------------------------------------------------------------------------
+            /// \brief Shortcut waiting end of contraction.
+            struct Shortcut
+            {
+                NodeID      _from;      ///< Source.
+                NodeID      _to;        ///< Target.
+                CostType    _cost;      ///< Cost through contracted node.
+            };
+
+            /// Maximum settled nodes by witness search (more = less shortcuts but slower build).
+            static const size_t _witnessLimit = 256;
+
+            Contractor(const size_t nbNodes):
+            _outArcs(nbNodes), _inArcs(nbNodes), _contracted(nbNodes, false), _deleted(nbNodes, 0)
+            {}
+
+            //------------------------------------------------------------------------
+            /// \brief  Add arc or lower weight of existing one.
+            ///
+            /// \param[in] from: source.
+            /// \param[in] to: target.
+            /// \param[in] weight: cost of arc.
+            /// \param[in] middle: bypassed node.
+            void addArc(const NodeID from, const NodeID to, const CostType weight, const NodeID middle)
+            {
+                for(auto& arc : _outArcs[from])
+                {
+                    if(arc._node == to)
+                    {
+                        if(weight < arc._weight)
+                        {
+                            arc._weight = weight;
+                            arc._middle = middle;
+                            for(auto& inArc : _inArcs[to])
+                            {
+                                if(inArc._node == from)
+                                {
+                                    inArc._weight = weight;
+                                    inArc._middle = middle;
+                                }
+                            }
+                        }
+                        return;
+                    }
+                }
+                _outArcs[from].push_back({ to, weight, middle });
+                _inArcs[to].push_back({ from, weight, middle });
+            }
+
+            //------------------------------------------------------------------------
+            /// \brief  Contract node: add shortcuts between its neighbors without witness path.
+            ///
+            /// \param[in] node: node to remove.
+            /// \param[in] simulate: only count shortcuts.
+            /// \returns Number of needed shortcuts.
+            size_t contract(const NodeID node, const bool simulate)
+            {
+                size_t nbShortcuts = 0;
+                _shortcuts.clear();
+                for(const auto& inArc : _inArcs[node])
+                {
+                    const NodeID from = inArc._node;
+                    if(_contracted[from])
+                        continue;
+
+                    // Longest path to bypass
+                    CostType maxCost = -1.0f;
+                    for(const auto& outArc : _outArcs[node])
+                    {
+                        if(!_contracted[outArc._node] && outArc._node != from)
+                            maxCost = std::max(maxCost, inArc._weight + outArc._weight);
+                    }
+                    if(maxCost < 0.0f)
+                        continue;
+
+                    searchWitness(from, node, maxCost);
+
+                    // Shortcut only if no other path is as good
+                    for(const auto& outArc : _outArcs[node])
+                    {
+                        const CostType cost = inArc._weight + outArc._weight;
+                        if(!_contracted[outArc._node] && outArc._node != from && cost < _witness.getCost(outArc._node))
+                        {
+                            ++nbShortcuts;
+                            if(!simulate)
+                                _shortcuts.push_back({ from, outArc._node, cost });
+                        }
+                    }
+                }
+
+                if(!simulate)
+                {
+                    for(const auto& shortcut : _shortcuts)
+                    {
+                        addArc(shortcut._from, shortcut._to, shortcut._cost, node);
+                    }
+
+                    _contracted[node] = true;
+                    for(const auto& arc : _outArcs[node])
+                        ++_deleted[arc._node];
+                    for(const auto& arc : _inArcs[node])
+                        ++_deleted[arc._node];
+                }
+                return nbShortcuts;
+            }
+
+            //------------------------------------------------------------------------
+            /// \brief  Get priority of node (lowest is contracted first).
+            ///
+            /// \param[in] node: not contracted node.
+            /// \returns Edge difference + contracted neighbors.
+            int computePriority(const NodeID node)
+            {
+                int nbRemoved = 0;
+                for(const auto& arc : _outArcs[node])
+                    nbRemoved += _contracted[arc._node] ? 0 : 1;
+                for(const auto& arc : _inArcs[node])
+                    nbRemoved += _contracted[arc._node] ? 0 : 1;
+
+                return static_cast<int>(contract(node, true)) - nbRemoved + static_cast<int>(_deleted[node]);
+            }
+
+            bool isContracted(const NodeID node) const
+            {
+                return _contracted[node];
+            }
+
+            const std::vector<BuildArc>& getOutArcs(const NodeID node) const
+            {
+                return _outArcs[node];
+            }
+
+        private:
+            //------------------------------------------------------------------------
+            /// \brief  Limited Dijkstra from source avoiding node being contracted.
+            ///
+            /// \param[in] from: source.
+            /// \param[in] avoid: node being contracted.
+            /// \param[in] maxCost: stop when all nodes under this cost are settled.
+            void searchWitness(const NodeID from, const NodeID avoid, const CostType maxCost)
+            {
+                _witness.prepare(_outArcs.size());
+                _witness.reach(from, 0.0f, from);
+                _witness.push(from, 0.0f, 0.0f);
+
+                size_t nbSettled = 0;
+                while(!_witness.isOpenEmpty() && nbSettled < _witnessLimit)
+                {
+                    const PathSearchContext::OpenNode current = _witness.pop();
+                    if(_witness.getCost(current._node) < current._cost)
+                        continue;
+                    if(current._cost > maxCost)
+                        break;
+                    ++nbSettled;
+
+                    for(const auto& arc : _outArcs[current._node])
+                    {
+                        if(arc._node == avoid || _contracted[arc._node])
+                            continue;
+                        const CostType cost = current._cost + arc._weight;
+                        if(cost < _witness.getCost(arc._node))
+                        {
+                            _witness.reach(arc._node, cost, current._node);
+                            _witness.push(arc._node, cost, cost);
+                        }
+                    }
+                }
+            }
+
+            std::vector<std::vector<BuildArc>>  _outArcs;       ///< Out arcs of each node.
+            std::vector<std::vector<BuildArc>>  _inArcs;        ///< In arcs of each node.
+            std::vector<bool>                   _contracted;    ///< Node is removed.
+            std::vector<BT::uint32>             _deleted;       ///< Number of contracted neighbors.
+            std::vector<Shortcut>               _shortcuts;     ///< Pending shortcuts of current node.
+            PathSearchContext                   _witness;       ///< Workspace of witness search.
+    };
+}
+
+void ContractionHierarchy::build(const PathWorld& world, const Agent::Navigation& navigation, bool speedMode)
+{
+    BT_PRE_CONDITION(isNull());         // DEV Issue: build() already called !
+    BT_PRE_CONDITION(!world.isNull());  // DEV Issue: World not initialized !
+
+    const TerrainGraph& graph = world.getGraph();
+    const size_t nbNodes = graph.getNbNodes();
+    const Agent agent(navigation);
+    const std::shared_ptr<const CostOverlay> overlay = world.getOverlay();
+    _overlayVersion = overlay ? overlay->getVersion() : 0;
+
+    // Copy graph with profile weight (blocked edges are removed)
+    Contractor contractor(nbNodes);
+    for(NodeID node = 0; node < nbNodes; ++node)
+    {
+        for(TerrainGraph::EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+        {
+            CostType weight = 0.0f;
+            if(overlay)
+                weight = speedMode ? world.updateSpeedWeight(edge, *overlay) : world.updateWeight(agent, node, edge, *overlay);
+            else
+                weight = speedMode ? world.updateSpeedWeight(edge) : world.updateWeight(agent, node, edge);
+
+            if(weight != std::numeric_limits<CostType>::infinity())
+                contractor.addArc(node, graph.getTarget(edge), weight, _noMiddle);
+        }
+    }
+
+    // Contract with lazy update of priority
+    using Priority = std::pair<int, NodeID>;
+    std::priority_queue<Priority, std::vector<Priority>, std::greater<Priority>> queue;
+    for(NodeID node = 0; node < nbNodes; ++node)
+    {
+        queue.emplace(contractor.computePriority(node), node);
+    }
+
+    _ranks.assign(nbNodes, 0);
+    _nbShortcuts = 0;
+    BT::uint32 rank = 0;
+    while(!queue.empty())
+    {
+        const NodeID node = queue.top().second;
+        queue.pop();
+        if(contractor.isContracted(node))
+            continue;
+
+        // Priority is outdated: try again later
+        const int priority = contractor.computePriority(node);
+        if(!queue.empty() && priority > queue.top().first)
+        {
+            queue.emplace(priority, node);
+            continue;
+        }
+
+        _nbShortcuts += contractor.contract(node, false);
+        _ranks[node] = rank++;
+    }
+    BT_ASSERT(rank == nbNodes);
+
+    // Split arcs by direction (each arc is stored at its lowest node)
+    std::vector<std::vector<Arc>> forwardArcs(nbNodes);
+    std::vector<std::vector<Arc>> backwardArcs(nbNodes);
+    for(NodeID node = 0; node < nbNodes; ++node)
+    {
+        for(const auto& arc : contractor.getOutArcs(node))
+        {
+            if(_ranks[node] < _ranks[arc._node])
+                forwardArcs[node].push_back({ arc._node, arc._weight, arc._middle });
+            else
+                backwardArcs[arc._node].push_back({ node, arc._weight, arc._middle });
+        }
+    }
+
+    // Compact in CSR
+    const auto compact = [nbNodes](const std::vector<std::vector<Arc>>& arcs, UpwardGraph& upward)
+    {
+        upward._offsets.assign(nbNodes + 1, 0);
+        for(NodeID node = 0; node < nbNodes; ++node)
+        {
+            upward._offsets[node + 1] = upward._offsets[node] + static_cast<BT::uint32>(arcs[node].size());
+        }
+        upward._arcs.reserve(upward._offsets.back());
+        for(const auto& nodeArcs : arcs)
+        {
+            upward._arcs.insert(upward._arcs.end(), nodeArcs.begin(), nodeArcs.end());
+        }
+    };
+    compact(forwardArcs,  _forward);
+    compact(backwardArcs, _backward);
+
+    _world = &world;
+
+    BT_POST_CONDITION(!isNull());
+}
+
+void ContractionHierarchy::release()
+{
+    BT_PRE_CONDITION(!isNull());    // DEV Issue: Need to call build before
+
+    _world = nullptr;
+    _nbShortcuts = 0;
+    _overlayVersion = 0;
+    _ranks      = std::vector<BT::uint32>();
+    _forward    = UpwardGraph();
+    _backward   = UpwardGraph();
+
+    BT_POST_CONDITION(isNull());
+}
+
+ContractionHierarchy::SearchResult ContractionHierarchy::computePath(const NodeID from, const NodeID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const
+{
+    BT_PRE_CONDITION(!isNull());                    // DEV Issue: Need to call build before
+    BT_PRE_CONDITION(from < _ranks.size());         // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(to   < _ranks.size());         // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(pathWay.empty());              // DEV Issue: Need an empty result!
+    BT_PRE_CONDITION(isUpToDate());                 // DEV Issue: Overlay changed: rebuild hierarchy !
+
+    SearchResult result{ false, 0, 0.0f };
+
+    // Parse only if inside same sub-graph (else never solution so don't waste time)
+    const TerrainGraph& graph = _world->getGraph();
+    if(graph.getSubgraphID(from) != graph.getSubgraphID(to))
+        return result;
+
+    PathSearchContext& forward  = context;
+    PathSearchContext& backward = context.getReverse();
+    forward.prepare(_ranks.size());
+    backward.prepare(_ranks.size());
+
+    forward.reach(from, 0.0f, from);
+    forward.push(from, 0.0f, 0.0f);
+    backward.reach(to, 0.0f, to);
+    backward.push(to, 0.0f, 0.0f);
+
+    // Both sides go up: stop when no side can improve best meeting
+    CostType best    = std::numeric_limits<CostType>::infinity();
+    NodeID   meeting = from;
+    while(true)
+    {
+        const CostType minForward  = forward.isOpenEmpty()  ? std::numeric_limits<CostType>::infinity() : forward.top()._estimation;
+        const CostType minBackward = backward.isOpenEmpty() ? std::numeric_limits<CostType>::infinity() : backward.top()._estimation;
+        if(std::min(minForward, minBackward) >= best)
+            break;
+
+        const bool isForward = minForward <= minBackward;
+        PathSearchContext&       side   = isForward ? forward   : backward;
+        const PathSearchContext& other  = isForward ? backward  : forward;
+        const UpwardGraph&       upward = isForward ? _forward  : _backward;
+
+        const PathSearchContext::OpenNode current = side.pop();
+        if(side.getCost(current._node) < current._cost)
+            continue;
+        ++result._nbExpansions;
+
+        if(other.isReached(current._node) && current._cost + other.getCost(current._node) < best)
+        {
+            best    = current._cost + other.getCost(current._node);
+            meeting = current._node;
+        }
+
+        for(BT::uint32 arcID = upward._offsets[current._node]; arcID != upward._offsets[current._node + 1]; ++arcID)
+        {
+            const Arc&     arc  = upward._arcs[arcID];
+            const CostType cost = current._cost + arc._weight;
+            if(cost < side.getCost(arc._node))
+            {
+                side.reach(arc._node, cost, current._node);
+                side.push(arc._node, cost, cost);
+            }
+        }
+    }
+
+    if(best == std::numeric_limits<CostType>::infinity())
+        return result;
+
+    result._found = true;
+    result._cost  = best;
+
+    // Goal side: build meeting -> to then flip it
+    pathWay.emplace_back(graph.getCentroid(meeting));
+    for(NodeID node = meeting; backward.getPredecessor(node) != node; node = backward.getPredecessor(node))
+    {
+        unpackArc(node, backward.getPredecessor(node), false, pathWay);
+    }
+    std::reverse(pathWay.begin(), pathWay.end());
+
+    // Start side: predecessors already go from meeting to start
+    for(NodeID node = meeting; forward.getPredecessor(node) != node; node = forward.getPredecessor(node))
+    {
+        unpackArc(forward.getPredecessor(node), node, true, pathWay);
+    }
+    return result;
+}
+
+template<typename Visitor>
+void ContractionHierarchy::searchUpward(const NodeID from, const bool isForward, PathSearchContext& context, Visitor visitor) const
+{
+    const UpwardGraph& upward   = isForward ? _forward  : _backward;
+    const UpwardGraph& downward = isForward ? _backward : _forward;
+
+    context.prepare(_ranks.size());
+    context.reach(from, 0.0f, from);
+    context.push(from, 0.0f, 0.0f);
+    while(!context.isOpenEmpty())
+    {
+        const PathSearchContext::OpenNode current = context.pop();
+        if(context.getCost(current._node) < current._cost)
+            continue;
+
+        // Stall: higher node already gives better cost, so node is never on a shortest path
+        bool isStalled = false;
+        for(BT::uint32 arcID = downward._offsets[current._node]; arcID != downward._offsets[current._node + 1] && !isStalled; ++arcID)
+        {
+            const Arc& arc = downward._arcs[arcID];
+            isStalled = context.getCost(arc._node) + arc._weight < current._cost;
+        }
+        if(isStalled)
+            continue;
+
+        visitor(current._node, current._cost);
+        for(BT::uint32 arcID = upward._offsets[current._node]; arcID != upward._offsets[current._node + 1]; ++arcID)
+        {
+            const Arc&     arc  = upward._arcs[arcID];
+            const CostType cost = current._cost + arc._weight;
+            if(cost < context.getCost(arc._node))
+            {
+                context.reach(arc._node, cost, current._node);
+                context.push(arc._node, cost, cost);
+            }
+        }
+    }
+}
+
+void ContractionHierarchy::computeCostMatrix(const std::vector<NodeID>& sources, const std::vector<NodeID>& targets, std::vector<CostType>& matrix, BT::ThreadPool& pool) const
+{
+    BT_PRE_CONDITION(!isNull());                    // DEV Issue: Need to call build before
+    BT_PRE_CONDITION(isUpToDate());                 // DEV Issue: Overlay changed: rebuild hierarchy !
+
+    const size_t nbTargets = targets.size();
+    matrix.assign(sources.size() * nbTargets, std::numeric_limits<CostType>::infinity());
+
+    // Search space of each target (backward)
+    std::vector<std::vector<std::pair<NodeID, CostType>>> spaces(nbTargets);
+    pool.parallelFor(nbTargets, [&](size_t targetID)
+    {
+        BT_PRE_CONDITION(targets[targetID] < _ranks.size());    // DEV Issue: Invalid input !
+        searchUpward(targets[targetID], false, PathSearchContext::getThreadContext(), [&](NodeID node, CostType cost)
+        {
+            spaces[targetID].emplace_back(node, cost);
+        });
+    });
+
+    // Buckets in CSR: entries of node are [offsets[node], offsets[node+1])
+    std::vector<BT::uint32> offsets(_ranks.size() + 1, 0);
+    for(const auto& space : spaces)
+    {
+        for(const auto& settled : space)
+        {
+            ++offsets[settled.first + 1];
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<BucketEntry> buckets(offsets.back());
+    std::vector<BT::uint32>  positions(offsets.begin(), offsets.end() - 1);
+    for(size_t targetID = 0; targetID < nbTargets; ++targetID)
+    {
+        for(const auto& settled : spaces[targetID])
+        {
+            buckets[positions[settled.first]++] = BucketEntry{ static_cast<BT::uint32>(targetID), settled.second };
+        }
+    }
+    spaces = std::vector<std::vector<std::pair<NodeID, CostType>>>();
+
+    // One row by source: meet target spaces on each settled node
+    pool.parallelFor(sources.size(), [&](size_t sourceID)
+    {
+        BT_PRE_CONDITION(sources[sourceID] < _ranks.size());    // DEV Issue: Invalid input !
+        CostType* row = matrix.data() + sourceID * nbTargets;
+        searchUpward(sources[sourceID], true, PathSearchContext::getThreadContext(), [&](NodeID node, CostType cost)
+        {
+            for(BT::uint32 entryID = offsets[node]; entryID != offsets[node + 1]; ++entryID)
+            {
+                const BucketEntry& entry = buckets[entryID];
+                row[entry._target] = std::min(row[entry._target], cost + entry._cost);
+            }
+        });
+    });
+}
+
+const ContractionHierarchy::Arc& ContractionHierarchy::findArc(const NodeID from, const NodeID to) const
+{
+    const bool isForward      = _ranks[from] < _ranks[to];
+    const UpwardGraph& upward = isForward ? _forward : _backward;
+    const NodeID lower        = isForward ? from : to;
+    const NodeID upper        = isForward ? to   : from;
+
+    for(BT::uint32 arcID = upward._offsets[lower]; arcID != upward._offsets[lower + 1]; ++arcID)
+    {
+        if(upward._arcs[arcID]._node == upper)
+            return upward._arcs[arcID];
+    }
+    throw std::exception(u8"ContractionHierarchy_Corruption");
+}
+
+void ContractionHierarchy::unpackArc(const NodeID from, const NodeID to, const bool reversed, std::vector<BoostPoint>& pathWay) const
+{
+    const Arc& arc = findArc(from, to);
+    if(arc._middle == _noMiddle)
+    {
+        pathWay.emplace_back(_world->getGraph().getCentroid(reversed ? from : to));
+    }
+    else if(!reversed)
+    {
+        unpackArc(from, arc._middle, false, pathWay);
+        unpackArc(arc._middle, to, false, pathWay);
+    }
+    else
+    {
+        unpackArc(arc._middle, to, true, pathWay);
+        unpackArc(from, arc._middle, true, pathWay);
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "PathWorld.h"
+
+//----------------------------------------------------------------------------
+/// \brief Contraction hierarchy of PathWorld graph for one agent profile.
+/// Nodes are contracted one by one (lowest edge difference first) and
+/// shortcuts keep shortest distances between remaining nodes. Query is a
+/// bidirectional Dijkstra going only to higher ranked nodes.
+/// \code{ .cpp }
+///     ContractionHierarchy hierarchy;
+///     hierarchy.build(world, agent.getNavigation());
+///     world.computePath(hierarchy, from, to, pathWay, context);
+/// \endcode
+/// \note Weight is asymmetric (height) so forward and backward arcs are kept separately.
+class ContractionHierarchy final
+{
+    BT_NOCOPY_NOMOVE(ContractionHierarchy);
+
+    public:
+        using NodeID       = PathWorld::WalkTerrainID;
+        using CostType     = PathWorld::CostType;
+        using SearchResult = PathWorld::SearchResult;
+
+        /// Constructor
+        ContractionHierarchy():
+        _world(nullptr), _nbShortcuts(0), _overlayVersion(0)
+        {}
+
+        /// Destructor
+        ~ContractionHierarchy()
+        {
+            BT_POST_CONDITION(isNull());    // DEV Issue: Call release() !
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Contract all nodes of world using weight of profile (with current overlay: rebuild after overrides).
+        ///
+        /// \param[in] world: initialized world (must live longer than hierarchy).
+        /// \param[in] navigation: agent profile (speed by terrain).
+        /// \param[in] speedMode: use only distance as weight (navigation is ignored).
+        void build(const PathWorld& world, const Agent::Navigation& navigation, bool speedMode = false);
+
+        //------------------------------------------------------------------------
+        /// \brief  Release all data.
+        ///
+        void release();
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if hierarchy is built.
+        ///
+        /// \returns True if null, false otherwise.
+        bool isNull() const
+        {
+            return _world == nullptr;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get world used to build hierarchy.
+        ///
+        /// \returns World.
+        const PathWorld& getWorld() const
+        {
+            BT_PRE_CONDITION(!isNull());
+            return *_world;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get number of shortcuts added by contraction.
+        ///
+        /// \returns Number of shortcuts.
+        size_t getNbShortcuts() const
+        {
+            return _nbShortcuts;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if hierarchy was built with current overlay of world.
+        ///
+        /// \returns True if up to date, false if overlay changed since build().
+        bool isUpToDate() const
+        {
+            BT_PRE_CONDITION(!isNull());
+            return _overlayVersion == _world->getOverlayVersion();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Bidirectional upward query then shortcut unpacking.
+        ///
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] pathWay: centroid of each node from goal to start.
+        /// \param[in,out] context: workspace of current thread (both sides are used).
+        /// \returns Goal found, number of settled nodes and cost of path.
+        SearchResult computePath(const NodeID from, const NodeID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Many-to-many costs with buckets: one backward upward search by target
+        /// fills buckets of nodes, then one forward upward search by source scans them.
+        ///
+        /// \param[in] sources: start nodes (one row each).
+        /// \param[in] targets: goal nodes (one column each).
+        /// \param[out] matrix: dense row-major costs (matrix[source * targets.size() + target], infinity if not reachable).
+        /// \param[in,out] pool: workers (each one uses its own PathSearchContext).
+        void computeCostMatrix(const std::vector<NodeID>& sources, const std::vector<NodeID>& targets, std::vector<CostType>& matrix, BT::ThreadPool& pool) const;
+
+    private:
+        static const NodeID _noMiddle = std::numeric_limits<NodeID>::max();   ///< Original edge marker.
+
+        //----------------------------------------------------------------------------
+        /// \brief Arc of hierarchy (original edge or shortcut).
+        struct Arc
+        {
+            NodeID      _node;      ///< Other extremity.
+            CostType    _weight;    ///< Cost of arc.
+            NodeID      _middle;    ///< Contracted node bypassed by shortcut (_noMiddle for edge).
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief Upward arcs in CSR layout.
+        struct UpwardGraph
+        {
+            std::vector<BT::uint32> _offsets;   ///< First arc of each node (size = nodes + 1).
+            std::vector<Arc>        _arcs;      ///< Arcs sorted by lower node.
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief Cost from bucket node to one target.
+        struct BucketEntry
+        {
+            BT::uint32  _target;    ///< Column of target.
+            CostType    _cost;      ///< Cost from node to target.
+        };
+
+        //------------------------------------------------------------------------
+        /// \brief  Dijkstra going only to higher ranked nodes (with stall-on-demand).
+        ///
+        /// \param[in] from: first node.
+        /// \param[in] isForward: follow arcs from -> to (else to -> from).
+        /// \param[in,out] context: workspace of current thread.
+        /// \param[in] visitor: called with each settled and not stalled node and its cost.
+        template<typename Visitor>
+        void searchUpward(const NodeID from, const bool isForward, PathSearchContext& context, Visitor visitor) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Find arc from -> to (lower node stores it).
+        ///
+        /// \param[in] from: source of original direction.
+        /// \param[in] to: target of original direction.
+        /// \returns Arc with lowest weight.
+        const Arc& findArc(const NodeID from, const NodeID to) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Append nodes of arc from -> to expanding shortcuts.
+        ///
+        /// \param[in] from: source of original direction.
+        /// \param[in] to: target of original direction.
+        /// \param[in] reversed: append to -> from without to (else from -> to without from).
+        /// \param[in,out] pathWay: centroids.
+        void unpackArc(const NodeID from, const NodeID to, const bool reversed, std::vector<BoostPoint>& pathWay) const;
+
+        const PathWorld*        _world;         ///< [LINK] Source world. WARNING: No destruction.
+        std::vector<BT::uint32> _ranks;         ///< Contraction order of each node.
+        UpwardGraph             _forward;       ///< Arcs from -> to with rank(from) < rank(to), stored at from.
+        UpwardGraph             _backward;      ///< Arcs from -> to with rank(to) < rank(from), stored at to.
+        size_t                  _nbShortcuts;   ///< Shortcuts added by contraction.
+        CostOverlay::Version    _overlayVersion;///< Overlay used by build().
+};
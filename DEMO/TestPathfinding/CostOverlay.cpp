@@ -0,0 +1,36 @@
+#include "CostOverlay.h"
+
+void CostOverlay::scaleEdge(const EdgeID edge, const float factor)
+{
+    BT_PRE_CONDITION(edge < _nbEdges);  // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(factor > 0.0f);    // DEV Issue: Weight must stay positive !
+
+    if(_edgeFactors.empty())
+    {
+        _edgeFactors.assign(_nbEdges, 1.0f);
+    }
+    _edgeFactors[edge] *= factor;
+    _minFactor = std::min(_minFactor, _edgeFactors[edge]);
+}
+
+void CostOverlay::resetEdge(const EdgeID edge)
+{
+    BT_PRE_CONDITION(edge < _nbEdges);  // DEV Issue: Invalid input !
+
+    if(!_edgeFactors.empty())
+    {
+        _edgeFactors[edge] = 1.0f;
+    }
+}
+
+void CostOverlay::setType(const NodeID node, const Type type)
+{
+    BT_PRE_CONDITION(node < _nbNodes);  // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(type <= NbType);   // DEV Issue: Invalid input !
+
+    if(_nodeTypes.empty())
+    {
+        _nodeTypes.assign(_nbNodes, static_cast<BT::uint8>(NbType));
+    }
+    _nodeTypes[node] = static_cast<BT::uint8>(type);
+}
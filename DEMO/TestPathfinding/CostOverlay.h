@@ -0,0 +1,115 @@
+#pragma once
+
+#include "TerrainGraph.h"
+
+//----------------------------------------------------------------------------
+/// \brief Runtime changes of PathWorld costs (flood, fire, blocked bridge).
+/// One snapshot is immutable once published: writers copy it, apply a batch
+/// then publish new version (see PathWorld::blockEdges()). Arrays are only
+/// allocated when first override of their kind is set.
+/// \code{ .cpp }
+///     world.blockEdges({ edge, graph.getReverseEdge(edge) });
+///     const auto overlay = world.getOverlay();    // Same snapshot for whole search
+/// \endcode
+class CostOverlay final
+{
+    public:
+        using NodeID  = TerrainGraph::NodeID;
+        using EdgeID  = TerrainGraph::EdgeID;
+        using Version = BT::uint32;
+
+        /// Constructor
+        CostOverlay(const size_t nbNodes, const size_t nbEdges):
+        _version(0), _nbNodes(nbNodes), _nbEdges(nbEdges), _minFactor(1.0f)
+        {}
+
+        /// Copy: base of next version
+        CostOverlay(const CostOverlay&) = default;
+
+        /// Destructor
+        ~CostOverlay() = default;
+
+        Version getVersion() const
+        {
+            return _version;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get multiplier of edge weight.
+        ///
+        /// \param[in] edge: edge of world graph.
+        /// \returns Factor (infinity if blocked).
+        float getFactor(const EdgeID edge) const
+        {
+            BT_PRE_CONDITION(edge < _nbEdges);
+            return _edgeFactors.empty() ? 1.0f : _edgeFactors[edge];
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get terrain of node.
+        ///
+        /// \param[in] node: node of world graph.
+        /// \param[in] type: terrain read from map.
+        /// \returns Override terrain or type if none.
+        Type getType(const NodeID node, const Type type) const
+        {
+            BT_PRE_CONDITION(node < _nbNodes);
+            return _nodeTypes.empty() || _nodeTypes[node] == NbType ? type : static_cast<Type>(_nodeTypes[node]);
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get lowest multiplier of all edges (to keep heuristic admissible).
+        ///
+        /// \returns Lowest factor (1 at most).
+        float getMinFactor() const
+        {
+            return _minFactor;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if terrain of some node was replaced (speed can be higher than map).
+        ///
+        /// \returns True if setType() was called, false otherwise.
+        bool hasTypes() const
+        {
+            return !_nodeTypes.empty();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Multiply weight of edge (infinity = blocked).
+        ///
+        /// \param[in] edge: edge of world graph.
+        /// \param[in] factor: positive multiplier.
+        void scaleEdge(const EdgeID edge, const float factor);
+
+        //------------------------------------------------------------------------
+        /// \brief  Remove multiplier of edge (blocked edge is opened).
+        ///
+        /// \param[in] edge: edge of world graph.
+        void resetEdge(const EdgeID edge);
+
+        //------------------------------------------------------------------------
+        /// \brief  Replace terrain of node (NbType = terrain of map).
+        ///
+        /// \param[in] node: node of world graph.
+        /// \param[in] type: new terrain.
+        void setType(const NodeID node, const Type type);
+
+        //------------------------------------------------------------------------
+        /// \brief  Set version of snapshot (before publication only).
+        ///
+        /// \param[in] version: new version.
+        void setVersion(const Version version)
+        {
+            _version = version;
+        }
+
+    private:
+        Version                 _version;       ///< Incremented by each published batch.
+        size_t                  _nbNodes;       ///< Number of nodes of graph.
+        size_t                  _nbEdges;       ///< Number of edges of graph.
+        float                   _minFactor;     ///< Lowest edge factor (never updated up).
+
+        std::vector<float>      _edgeFactors;   ///< [OWNERSHIP] Multiplier of each edge (empty = 1).
+        std::vector<BT::uint8>  _nodeTypes;     ///< [OWNERSHIP] Terrain of each node (empty or NbType = map).
+};
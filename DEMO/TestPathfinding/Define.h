@@ -28,6 +28,7 @@
 #include <deque>
 #include <stack>
 #include <array>
+#include <numeric>
 
 // STD C++ 11
 #include <atomic>
@@ -38,6 +39,7 @@
 #include <mutex>
 #include <random>
 #include <thread>
+#include <unordered_map>
 
 // Load filesystem of C++17
 #include <filesystem>
@@ -82,6 +84,7 @@
 #include <boost/geometry/geometries/point_xy.hpp>
 #include <boost/geometry/geometries/polygon.hpp>
 
+#include <boost/iterator/function_output_iterator.hpp>
 #include <boost/random.hpp>
 
 #pragma warning(pop)
@@ -92,6 +95,7 @@ namespace bgi = bg::index;
 using BoostPoint    = boost::geometry::model::point<float, 2, bg::cs::cartesian>;
 using BoostBox      = boost::geometry::model::box<BoostPoint>;
 using BoostPolygon  = boost::geometry::model::polygon<BoostPoint, false, false>;   ///< None-closed CounterClock polygon
+using BoostMultiPolygon = boost::geometry::model::multi_polygon<BoostPolygon>;
 
 // GRRRRRrrrr !
 #undef min
@@ -0,0 +1,129 @@
+#include "GridIndex.h"
+
+void GridIndex::build(const std::vector<Item>& items, bool multiLevel)
+{
+    BT_PRE_CONDITION(isNull());         // DEV Issue: build() already called !
+    BT_PRE_CONDITION(!items.empty());   // DEV Issue: Invalid input !
+
+    BoostBox bounds = items.front().first;
+    std::vector<float> sizes;
+    sizes.reserve(items.size());
+    for(const Item& item : items)
+    {
+        bg::expand(bounds, item.first);
+        sizes.push_back(std::max(item.first.max_corner().get<0>() - item.first.min_corner().get<0>(), item.first.max_corner().get<1>() - item.first.min_corner().get<1>()));
+    }
+    _origin = bounds.min_corner();
+    _extent = bounds.max_corner();
+    const float width  = std::max(_extent.get<0>() - _origin.get<0>(), 1.0f);
+    const float height = std::max(_extent.get<1>() - _origin.get<1>(), 1.0f);
+
+    // Median box: most polygons overlap few cells
+    std::nth_element(sizes.begin(), sizes.begin() + sizes.size() / 2, sizes.end());
+    float cellSize = std::max(sizes[sizes.size() / 2], 1e-3f);
+
+    // Keep number of cells bounded
+    const float maxCells = static_cast<float>(_maxCellsByItem * items.size());
+    while((width / cellSize + 1.0f) * (height / cellSize + 1.0f) > maxCells)
+    {
+        cellSize *= 2.0f;
+    }
+
+    if(!multiLevel)
+    {
+        std::vector<BT::uint32> itemIDs(items.size());
+        std::iota(itemIDs.begin(), itemIDs.end(), 0);
+        _levels.resize(1);
+        _levels.front()._cellSize = cellSize;
+        fillLevel(items, itemIDs, _levels.front());
+        return;
+    }
+
+    // Each box goes to first level where cell is bigger than box
+    std::vector<std::vector<BT::uint32>> itemsByLevel;
+    for(BT::uint32 itemID = 0; itemID < items.size(); ++itemID)
+    {
+        const BoostBox& box = items[itemID].first;
+        const float size = std::max(box.max_corner().get<0>() - box.min_corner().get<0>(), box.max_corner().get<1>() - box.min_corner().get<1>());
+        size_t levelID = 0;
+        for(float levelSize = cellSize; levelSize < size; levelSize *= 2.0f)
+        {
+            ++levelID;
+        }
+        if(levelID >= itemsByLevel.size())
+        {
+            itemsByLevel.resize(levelID + 1);
+        }
+        itemsByLevel[levelID].push_back(itemID);
+    }
+
+    float levelSize = cellSize;
+    for(const auto& itemIDs : itemsByLevel)
+    {
+        if(!itemIDs.empty())
+        {
+            _levels.emplace_back();
+            _levels.back()._cellSize = levelSize;
+            fillLevel(items, itemIDs, _levels.back());
+        }
+        levelSize *= 2.0f;
+    }
+
+    BT_POST_CONDITION(!isNull());
+}
+
+void GridIndex::fillLevel(const std::vector<Item>& items, const std::vector<BT::uint32>& itemIDs, Level& level) const
+{
+    level._nbX = static_cast<BT::uint32>((_extent.get<0>() - _origin.get<0>()) / level._cellSize) + 1;
+    level._nbY = static_cast<BT::uint32>((_extent.get<1>() - _origin.get<1>()) / level._cellSize) + 1;
+
+    // Range of cells covered by box
+    const auto forEachCell = [&](const BoostBox& box, auto function)
+    {
+        const BT::uint32 minX = static_cast<BT::uint32>((box.min_corner().get<0>() - _origin.get<0>()) / level._cellSize);
+        const BT::uint32 minY = static_cast<BT::uint32>((box.min_corner().get<1>() - _origin.get<1>()) / level._cellSize);
+        const BT::uint32 maxX = std::min(static_cast<BT::uint32>((box.max_corner().get<0>() - _origin.get<0>()) / level._cellSize), level._nbX - 1);
+        const BT::uint32 maxY = std::min(static_cast<BT::uint32>((box.max_corner().get<1>() - _origin.get<1>()) / level._cellSize), level._nbY - 1);
+        for(BT::uint32 y = minY; y <= maxY; ++y)
+        {
+            for(BT::uint32 x = minX; x <= maxX; ++x)
+            {
+                function(static_cast<size_t>(y) * level._nbX + x);
+            }
+        }
+    };
+
+    // Count then fill (CSR)
+    level._offsets.assign(static_cast<size_t>(level._nbX) * level._nbY + 1, 0);
+    for(const BT::uint32 itemID : itemIDs)
+    {
+        forEachCell(items[itemID].first, [&](size_t cell) { ++level._offsets[cell + 1]; });
+    }
+    std::partial_sum(level._offsets.begin(), level._offsets.end(), level._offsets.begin());
+
+    level._items.resize(level._offsets.back());
+    std::vector<BT::uint32> positions(level._offsets.begin(), level._offsets.end() - 1);
+    for(const BT::uint32 itemID : itemIDs)
+    {
+        forEachCell(items[itemID].first, [&](size_t cell) { level._items[positions[cell]++] = items[itemID].second; });
+    }
+}
+
+void GridIndex::release()
+{
+    BT_PRE_CONDITION(!isNull());    // DEV Issue: Need to call build before
+
+    _levels = std::vector<Level>();
+
+    BT_POST_CONDITION(isNull());
+}
+
+size_t GridIndex::getMemorySize() const
+{
+    size_t size = 0;
+    for(const Level& level : _levels)
+    {
+        size += level._offsets.capacity() * sizeof(BT::uint32) + level._items.capacity() * sizeof(NodeID);
+    }
+    return size;
+}
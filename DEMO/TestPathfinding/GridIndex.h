@@ -0,0 +1,116 @@
+#pragma once
+
+#include "TerrainGraph.h"
+
+//----------------------------------------------------------------------------
+/// \brief Grid of boxes for point location (alternative to R*-tree).
+/// Uniform grid: one level, each cell lists all boxes overlapping it.
+/// Multi-level grid: cell size doubles at each level and each box is stored
+/// at the first level where it overlaps at most 2x2 cells (big boxes never
+/// fill thousands of small cells).
+/// \code{ .cpp }
+///     GridIndex grid;
+///     grid.build(boxes, true);
+///     grid.query(point, [&](GridIndex::NodeID node) { return isInside(node, point); });
+/// \endcode
+class GridIndex final
+{
+    BT_NOCOPY(GridIndex);
+
+    public:
+        using NodeID = TerrainGraph::NodeID;
+        using Item   = std::pair<BoostBox, NodeID>;     ///< Same as PathWorld::AreaBox.
+
+        static const size_t _maxCellsByItem = 16;       ///< Limit of memory for uniform grid.
+
+        /// Constructor
+        GridIndex() = default;
+
+        GridIndex(GridIndex&&) = default;
+        GridIndex& operator=(GridIndex&&) = default;
+
+        /// Destructor
+        ~GridIndex() = default;
+
+        //------------------------------------------------------------------------
+        /// \brief  Build cells (base cell size is median size of boxes).
+        ///
+        /// \param[in] items: box of each node.
+        /// \param[in] multiLevel: add coarser levels for big boxes (else one uniform level).
+        void build(const std::vector<Item>& items, bool multiLevel);
+
+        //------------------------------------------------------------------------
+        /// \brief  Release all data.
+        ///
+        void release();
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if grid is built.
+        ///
+        /// \returns True if null, false otherwise.
+        bool isNull() const
+        {
+            return _levels.empty();
+        }
+
+        size_t getNbLevels() const
+        {
+            return _levels.size();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get memory used by cells (bytes).
+        ///
+        /// \returns Size of offsets and items of all levels.
+        size_t getMemorySize() const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Visit nodes whose box may contain point (one cell by level).
+        ///
+        /// \param[in] point: point in world coordinate.
+        /// \param[in] visitor: called with each candidate, returns true to stop.
+        /// \returns True if stopped by visitor.
+        template<typename Visitor>
+        bool query(const BoostPoint& point, Visitor visitor) const
+        {
+            for(const Level& level : _levels)
+            {
+                const float x = (point.get<0>() - _origin.get<0>()) / level._cellSize;
+                const float y = (point.get<1>() - _origin.get<1>()) / level._cellSize;
+                if(x < 0.0f || y < 0.0f || x >= static_cast<float>(level._nbX) || y >= static_cast<float>(level._nbY))
+                    continue;
+
+                const size_t cell = static_cast<size_t>(y) * level._nbX + static_cast<size_t>(x);
+                for(BT::uint32 itemID = level._offsets[cell]; itemID != level._offsets[cell + 1]; ++itemID)
+                {
+                    if(visitor(level._items[itemID]))
+                        return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        //----------------------------------------------------------------------------
+        /// \brief Cells of one size in CSR layout.
+        struct Level
+        {
+            float                   _cellSize;  ///< Side of cell.
+            BT::uint32              _nbX;       ///< Number of columns.
+            BT::uint32              _nbY;       ///< Number of rows.
+            std::vector<BT::uint32> _offsets;   ///< First item of each cell (size = cells + 1).
+            std::vector<NodeID>     _items;     ///< Nodes sorted by cell.
+        };
+
+        //------------------------------------------------------------------------
+        /// \brief  Fill cells of level with its boxes.
+        ///
+        /// \param[in] items: all boxes.
+        /// \param[in] itemIDs: boxes stored at this level.
+        /// \param[in,out] level: cell size is set, cells are filled.
+        void fillLevel(const std::vector<Item>& items, const std::vector<BT::uint32>& itemIDs, Level& level) const;
+
+        BoostPoint          _origin;    ///< Lowest corner of all boxes.
+        BoostPoint          _extent;    ///< Highest corner of all boxes.
+        std::vector<Level>  _levels;    ///< [OWNERSHIP] Finest level first.
+};
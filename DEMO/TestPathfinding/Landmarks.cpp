@@ -0,0 +1,107 @@
+#include "Landmarks.h"
+
+void Landmarks::build(const PathWorld& world, const Agent::Navigation& navigation, const size_t nbLandmarks, bool speedMode)
+{
+    BT_PRE_CONDITION(isNull());         // DEV Issue: build() already called !
+    BT_PRE_CONDITION(!world.isNull());  // DEV Issue: World not initialized !
+    BT_PRE_CONDITION(nbLandmarks > 0);  // DEV Issue: Need one landmark at least !
+
+    const TerrainGraph& graph = world.getGraph();
+    const size_t nbNodes = graph.getNbNodes();
+    const Agent agent(navigation);
+
+    _navigation  = navigation;
+    _speedMode   = speedMode;
+    _nbLandmarks = nbLandmarks;
+    _fromLandmarks.assign(nbNodes * nbLandmarks, 0.0f);
+    _toLandmarks.assign(nbNodes * nbLandmarks, 0.0f);
+
+    // Group nodes by sub-graph
+    std::map<BT::uint16, std::vector<NodeID>> subgraphs;
+    for(NodeID node = 0; node < nbNodes; ++node)
+    {
+        subgraphs[graph.getSubgraphID(node)].push_back(node);
+    }
+
+    const auto weight = [&](const NodeID from, const TerrainGraph::EdgeID edge)
+    {
+        return speedMode ? world.updateSpeedWeight(edge) : world.updateWeight(agent, from, edge);
+    };
+
+    // Full Dijkstra: cost of each node stays into context
+    PathSearchContext context;
+    const auto dijkstra = [&](const NodeID source, const bool reverse)
+    {
+        context.prepare(nbNodes);
+        context.reach(source, 0.0f, source);
+        context.push(source, 0.0f, 0.0f);
+        while(!context.isOpenEmpty())
+        {
+            const PathSearchContext::OpenNode current = context.pop();
+            if(context.getCost(current._node) < current._cost)
+                continue;
+
+            for(TerrainGraph::EdgeID edge = graph.beginEdge(current._node); edge != graph.endEdge(current._node); ++edge)
+            {
+                const NodeID   next = graph.getTarget(edge);
+                const CostType cost = current._cost + (reverse ? weight(next, graph.getReverseEdge(edge)) : weight(current._node, edge));
+                if(cost < context.getCost(next))
+                {
+                    context.reach(next, cost, current._node);
+                    context.push(next, cost, cost);
+                }
+            }
+        }
+    };
+
+    for(const auto& subgraph : subgraphs)
+    {
+        const std::vector<NodeID>& nodes = subgraph.second;
+
+        // Start from farthest node of any node
+        dijkstra(nodes.front(), false);
+        NodeID candidate = *std::max_element(nodes.begin(), nodes.end(), [&](NodeID a, NodeID b) { return context.getCost(a) < context.getCost(b); });
+
+        // Next landmark is farthest from all selected ones
+        std::vector<CostType> minDistances(nodes.size(), std::numeric_limits<CostType>::infinity());
+        const size_t nbSelected = std::min(nbLandmarks, nodes.size());
+        for(size_t landmark = 0; landmark < nbSelected; ++landmark)
+        {
+            _landmarks.push_back(candidate);
+
+            dijkstra(candidate, false);
+            for(size_t nodeID = 0; nodeID < nodes.size(); ++nodeID)
+            {
+                const CostType cost = context.getCost(nodes[nodeID]);
+                BT_ASSERT(cost < std::numeric_limits<CostType>::infinity()); // DEV Issue: Sub-graph is not connected !
+                _fromLandmarks[nodes[nodeID] * nbLandmarks + landmark] = cost;
+                minDistances[nodeID] = std::min(minDistances[nodeID], cost);
+            }
+
+            dijkstra(candidate, true);
+            for(const NodeID node : nodes)
+            {
+                _toLandmarks[node * nbLandmarks + landmark] = context.getCost(node);
+            }
+
+            candidate = nodes[std::max_element(minDistances.begin(), minDistances.end()) - minDistances.begin()];
+        }
+    }
+
+    _world = &world;
+
+    BT_POST_CONDITION(!isNull());
+}
+
+void Landmarks::release()
+{
+    BT_PRE_CONDITION(!isNull());    // DEV Issue: Need to call build before
+
+    _world       = nullptr;
+    _nbLandmarks = 0;
+    _landmarks     = std::vector<NodeID>();
+    _fromLandmarks = std::vector<CostType>();
+    _toLandmarks   = std::vector<CostType>();
+
+    BT_POST_CONDITION(isNull());
+}
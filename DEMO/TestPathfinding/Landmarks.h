@@ -0,0 +1,114 @@
+#pragma once
+
+#include "PathWorld.h"
+
+//----------------------------------------------------------------------------
+/// \brief Landmarks of PathWorld graph for ALT heuristic (A*, Landmarks, Triangle inequality).
+/// For each landmark L we keep d(L, node) and d(node, L) for one agent profile, then
+/// d(node, goal) >= max(d(L, goal) - d(L, node), d(node, L) - d(goal, L)).
+/// This bound never overestimates so A* stays optimal.
+/// \code{ .cpp }
+///     Landmarks landmarks;
+///     landmarks.build(world, agent.getNavigation(), 8);
+///     world.computePath(agent, landmarks, from, to, pathWay, context);
+/// \endcode
+/// \note Distances use map weights (no cost overlay): search scales them by
+/// lowest overlay factor, or uses distance bound if terrain was replaced.
+class Landmarks final
+{
+    BT_NOCOPY_NOMOVE(Landmarks);
+
+    public:
+        using NodeID   = PathWorld::WalkTerrainID;
+        using CostType = PathWorld::CostType;
+
+        /// Constructor
+        Landmarks():
+        _world(nullptr), _nbLandmarks(0), _speedMode(false)
+        {}
+
+        /// Destructor
+        ~Landmarks()
+        {
+            BT_POST_CONDITION(isNull());    // DEV Issue: Call release() !
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Select landmarks (farthest first) in each sub-graph and compute distances.
+        ///
+        /// \param[in] world: initialized world (must live longer than landmarks).
+        /// \param[in] navigation: agent profile (speed by terrain).
+        /// \param[in] nbLandmarks: number of landmarks by sub-graph.
+        /// \param[in] speedMode: use only distance as weight (navigation is ignored).
+        void build(const PathWorld& world, const Agent::Navigation& navigation, const size_t nbLandmarks, bool speedMode = false);
+
+        //------------------------------------------------------------------------
+        /// \brief  Release all data.
+        ///
+        void release();
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if landmarks are built.
+        ///
+        /// \returns True if null, false otherwise.
+        bool isNull() const
+        {
+            return _world == nullptr;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if landmarks were computed for this profile.
+        ///
+        /// \param[in] world: world to search.
+        /// \param[in] navigation: agent profile.
+        /// \param[in] speedMode: use only distance as weight.
+        /// \returns True if compatible, false otherwise.
+        bool isCompatible(const PathWorld& world, const Agent::Navigation& navigation, bool speedMode) const
+        {
+            return _world == &world && _speedMode == speedMode && (speedMode || _navigation._speed == navigation._speed);
+        }
+
+        bool isSpeedMode() const
+        {
+            return _speedMode;
+        }
+
+        size_t getNbLandmarks() const
+        {
+            return _nbLandmarks;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Lower bound of cost from node to goal (same sub-graph).
+        ///
+        /// \param[in] node: current node.
+        /// \param[in] goal: goal node.
+        /// \returns Estimation never greater than real cost.
+        CostType estimate(const NodeID node, const NodeID goal) const
+        {
+            BT_PRE_CONDITION(!isNull());
+
+            const CostType* fromNode = &_fromLandmarks[node * _nbLandmarks];
+            const CostType* toNode   = &_toLandmarks[node * _nbLandmarks];
+            const CostType* fromGoal = &_fromLandmarks[goal * _nbLandmarks];
+            const CostType* toGoal   = &_toLandmarks[goal * _nbLandmarks];
+
+            CostType bound = 0.0f;
+            for(size_t landmark = 0; landmark < _nbLandmarks; ++landmark)
+            {
+                bound = std::max(bound, fromGoal[landmark] - fromNode[landmark]);
+                bound = std::max(bound, toNode[landmark]   - toGoal[landmark]);
+            }
+            return bound;
+        }
+
+    private:
+        const PathWorld*        _world;         ///< [LINK] Source world. WARNING: No destruction.
+        Agent::Navigation       _navigation;    ///< Profile used for distances.
+        size_t                  _nbLandmarks;   ///< Landmarks by sub-graph (stride of arrays).
+        bool                    _speedMode;     ///< Distance only weight.
+
+        std::vector<NodeID>     _landmarks;     ///< [OWNERSHIP] Selected nodes (all sub-graphs).
+        std::vector<CostType>   _fromLandmarks; ///< [OWNERSHIP] d(L, node) at [node * _nbLandmarks + L] (L of node sub-graph).
+        std::vector<CostType>   _toLandmarks;   ///< [OWNERSHIP] d(node, L) at [node * _nbLandmarks + L] (L of node sub-graph).
+};
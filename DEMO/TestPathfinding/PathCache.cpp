@@ -0,0 +1,92 @@
+#include "PathCache.h"
+
+BT::uint64 PathCache::hashSpeed(const std::array<float, NbType>& speed)
+{
+    BT::uint64 hash = 0xCBF29CE484222325ull;
+    const BT::uint8* bytes = reinterpret_cast<const BT::uint8*>(speed.data());
+    for(size_t byte = 0; byte < sizeof(float) * speed.size(); ++byte)
+    {
+        hash ^= bytes[byte];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+bool PathCache::find(const Key& key, std::vector<NodeID>& nodes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto found = _index.find(key);
+    if(found == _index.end())
+    {
+        ++_nbMisses;
+        return false;
+    }
+
+    // Most recently used first
+    _entries.splice(_entries.begin(), _entries, found->second);
+    nodes.assign(found->second->_nodes.begin(), found->second->_nodes.end());
+    ++_nbHits;
+    return true;
+}
+
+void PathCache::insert(const Key& key, std::vector<NodeID>&& nodes)
+{
+    BT_PRE_CONDITION(!nodes.empty());   // DEV Issue: Only store valid route !
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Never fit: keep other routes
+    if(nodes.size() > _capacity)
+        return;
+
+    const auto found = _index.find(key);
+    if(found != _index.end())
+    {
+        _nbNodes -= found->second->_nodes.size();
+        _entries.erase(found->second);
+        _index.erase(found);
+    }
+
+    nodes.shrink_to_fit();
+    _nbNodes += nodes.size();
+    _entries.push_front(Entry{ key, std::move(nodes) });
+    _index.emplace(key, _entries.begin());
+
+    evict();
+
+    BT_POST_CONDITION(_nbNodes <= _capacity);
+    BT_POST_CONDITION(_index.size() == _entries.size());
+}
+
+void PathCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _index.clear();
+    _entries.clear();
+    _nbNodes  = 0;
+    _nbHits   = 0;
+    _nbMisses = 0;
+}
+
+void PathCache::setCapacity(const size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _capacity = capacity;
+    evict();
+}
+
+void PathCache::evict()
+{
+    while(_nbNodes > _capacity)
+    {
+        BT_ASSERT(!_entries.empty());
+
+        const Entry& oldest = _entries.back();
+        _nbNodes -= oldest._nodes.size();
+        _index.erase(oldest._key);
+        _entries.pop_back();
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "PathSearchContext.h"
+#include "TerrainGraph.h"
+
+//----------------------------------------------------------------------------
+/// \brief Thread-safe LRU cache of computed routes.
+/// Route is stored as node IDs (goal to start) and memory is bounded by total
+/// number of stored nodes: least recently used routes are dropped first.
+/// \code{ .cpp }
+///     PathCache cache(100000);
+///     const PathCache::Key key{ from, to, PathCache::hashSpeed(navigation._speed), false, 0, 0 };
+///     if(!cache.find(key, nodes)) { compute(nodes); cache.insert(key, std::move(nodes)); }
+/// \endcode
+class PathCache final
+{
+    BT_NOCOPY_NOMOVE(PathCache);
+
+    public:
+        using NodeID = PathSearchContext::NodeID;
+
+        static const size_t _defaultCapacity = 1 << 20;     ///< Default number of stored nodes (4 MB of IDs).
+
+        //----------------------------------------------------------------------------
+        /// \brief Identity of route.
+        struct Key
+        {
+            NodeID      _from;          ///< Start node.
+            NodeID      _to;            ///< Goal node.
+            BT::uint64  _profile;       ///< Hash of agent speeds (0 in speed mode).
+            bool        _speedMode;     ///< Only distance as weight.
+            BT::uint8   _mode;          ///< Kind of search (paths can differ).
+            BT::uint32  _version;       ///< Version of cost overlay (old routes are never read).
+
+            bool operator==(const Key& other) const
+            {
+                return _from == other._from && _to == other._to && _profile == other._profile && _speedMode == other._speedMode && _mode == other._mode && _version == other._version;
+            }
+        };
+
+        /// Constructor
+        explicit PathCache(const size_t capacity = _defaultCapacity):
+        _capacity(capacity), _nbNodes(0), _nbHits(0), _nbMisses(0)
+        {}
+
+        /// Destructor
+        ~PathCache() = default;
+
+        //------------------------------------------------------------------------
+        /// \brief  Hash agent speeds (FNV-1a on bytes) to build key.
+        ///
+        /// \param[in] speed: speed by terrain.
+        /// \returns Hash of profile.
+        static BT::uint64 hashSpeed(const std::array<float, NbType>& speed);
+
+        //------------------------------------------------------------------------
+        /// \brief  Read route and mark it as most recently used.
+        ///
+        /// \param[in] key: route to find.
+        /// \param[out] nodes: node IDs from goal to start (only if found).
+        /// \returns True if route is stored (hit), false otherwise (miss).
+        bool find(const Key& key, std::vector<NodeID>& nodes);
+
+        //------------------------------------------------------------------------
+        /// \brief  Store route (replace same key) then drop oldest routes above capacity.
+        ///
+        /// \param[in] key: route identity.
+        /// \param[in] nodes: node IDs from goal to start.
+        void insert(const Key& key, std::vector<NodeID>&& nodes);
+
+        //------------------------------------------------------------------------
+        /// \brief  Remove all routes and reset counters.
+        ///
+        void clear();
+
+        //------------------------------------------------------------------------
+        /// \brief  Change maximum number of stored nodes (drop oldest routes if needed).
+        ///
+        /// \param[in] capacity: maximum number of nodes of all routes.
+        void setCapacity(const size_t capacity);
+
+        size_t getCapacity() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _capacity;
+        }
+
+        size_t getNbEntries() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _entries.size();
+        }
+
+        size_t getNbNodes() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _nbNodes;
+        }
+
+        BT::uint64 getNbHits() const
+        {
+            return _nbHits;
+        }
+
+        BT::uint64 getNbMisses() const
+        {
+            return _nbMisses;
+        }
+
+    private:
+        //----------------------------------------------------------------------------
+        /// \brief Stored route.
+        struct Entry
+        {
+            Key                 _key;       ///< Identity.
+            std::vector<NodeID> _nodes;     ///< Node IDs from goal to start.
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief Hash of key for index.
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                BT::uint64 hash = key._profile ^ (static_cast<BT::uint64>(key._from) << 32 | key._to);
+                hash ^= static_cast<BT::uint64>(key._speedMode) << 1 | static_cast<BT::uint64>(key._mode) << 8 | static_cast<BT::uint64>(key._version) << 16;
+                return static_cast<size_t>(hash * 0x9E3779B97F4A7C15ull);
+            }
+        };
+
+        //------------------------------------------------------------------------
+        /// \brief  Drop least recently used routes until capacity is respected (lock must be taken).
+        ///
+        void evict();
+
+        using Entries = std::list<Entry>;
+
+        mutable std::mutex                                          _mutex;     ///< Protect all except counters.
+        Entries                                                     _entries;   ///< [OWNERSHIP] Routes, most recently used first.
+        std::unordered_map<Key, Entries::iterator, KeyHash>         _index;     ///< Position of each route.
+        size_t                                                      _capacity;  ///< Maximum number of stored nodes.
+        size_t                                                      _nbNodes;   ///< Stored nodes.
+
+        std::atomic<BT::uint64>                                     _nbHits;    ///< Found routes.
+        std::atomic<BT::uint64>                                     _nbMisses;  ///< Missing routes.
+};
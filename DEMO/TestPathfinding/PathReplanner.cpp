@@ -0,0 +1,212 @@
+#include "PathReplanner.h"
+#include "WeightProfile.h"
+
+void PathReplanner::initialize(const WeightProfile& profile, const NodeID start, const NodeID goal)
+{
+    BT_PRE_CONDITION(isNull());                 // DEV Issue: initialize() already called !
+    BT_PRE_CONDITION(!profile.isNull());        // DEV Issue: Profile not built !
+    BT_PRE_CONDITION(profile.isUpToDate());     // DEV Issue: Overlay changed: rebuild profile !
+
+    const size_t nbNodes = profile.getWorld().getGraph().getNbNodes();
+    BT_PRE_CONDITION(start < nbNodes);          // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(goal  < nbNodes);          // DEV Issue: Invalid input !
+
+    _profile     = &profile;
+    _start       = start;
+    _goal        = goal;
+    _last        = start;
+    _keyModifier = 0.0f;
+
+    _g.assign(nbNodes, std::numeric_limits<CostType>::infinity());
+    _rhs.assign(nbNodes, std::numeric_limits<CostType>::infinity());
+    _keys.assign(nbNodes, Key{ 0.0f, 0.0f });
+    _isOpen.assign(nbNodes, false);
+
+    // Search goes backward: goal is the only consistent seed
+    _rhs[goal] = 0.0f;
+    _keys[goal] = computeKey(goal);
+    _isOpen[goal] = true;
+    _openList.push({ _keys[goal], goal });
+
+    BT_POST_CONDITION(!isNull());
+}
+
+void PathReplanner::release()
+{
+    BT_PRE_CONDITION(!isNull());    // DEV Issue: Need to call initialize before
+
+    _profile = nullptr;
+    _g      = std::vector<CostType>();
+    _rhs    = std::vector<CostType>();
+    _keys   = std::vector<Key>();
+    _isOpen = std::vector<bool>();
+    _openList = std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>>();
+
+    BT_POST_CONDITION(isNull());
+}
+
+PathReplanner::CostType PathReplanner::estimate(const NodeID node) const
+{
+    const TerrainGraph& graph = _profile->getWorld().getGraph();
+    return _profile->getMinCostByDistance() * static_cast<CostType>(bg::distance(graph.getCentroid(_start), graph.getCentroid(node)));
+}
+
+PathReplanner::Key PathReplanner::computeKey(const NodeID node) const
+{
+    const CostType cost = std::min(_g[node], _rhs[node]);
+    return Key{ cost + estimate(node) + _keyModifier, cost };
+}
+
+void PathReplanner::moveTo(const NodeID start)
+{
+    BT_PRE_CONDITION(!isNull());            // DEV Issue: Need to call initialize before
+    BT_PRE_CONDITION(start < _g.size());    // DEV Issue: Invalid input !
+
+    // Old keys stay lower bounds if shifted by heuristic between both positions
+    _start = start;
+    _keyModifier += estimate(_last);
+    _last = start;
+}
+
+void PathReplanner::updateEdges(const std::vector<EdgeID>& edges)
+{
+    BT_PRE_CONDITION(!isNull());            // DEV Issue: Need to call initialize before
+
+    const TerrainGraph& graph = _profile->getWorld().getGraph();
+    for(const EdgeID edge : edges)
+    {
+        updateNode(graph.getTarget(graph.getReverseEdge(edge)));
+    }
+}
+
+void PathReplanner::updateNodes(const std::vector<NodeID>& nodes)
+{
+    BT_PRE_CONDITION(!isNull());            // DEV Issue: Need to call initialize before
+
+    const TerrainGraph& graph = _profile->getWorld().getGraph();
+    for(const NodeID node : nodes)
+    {
+        updateNode(node);
+        for(EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+        {
+            updateNode(graph.getTarget(edge));
+        }
+    }
+}
+
+void PathReplanner::updateNode(const NodeID node)
+{
+    if(node != _goal)
+    {
+        const TerrainGraph& graph = _profile->getWorld().getGraph();
+        CostType rhs = std::numeric_limits<CostType>::infinity();
+        for(EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+        {
+            rhs = std::min(rhs, _profile->getWeight(edge) + _g[graph.getTarget(edge)]);
+        }
+        _rhs[node] = rhs;
+    }
+
+    // Old entry is skipped when popped
+    _isOpen[node] = false;
+    if(_g[node] != _rhs[node])
+    {
+        _keys[node]   = computeKey(node);
+        _isOpen[node] = true;
+        _openList.push({ _keys[node], node });
+    }
+}
+
+bool PathReplanner::skipOldEntries()
+{
+    while(!_openList.empty())
+    {
+        const OpenNode& top = _openList.top();
+        if(_isOpen[top._node] && _keys[top._node] == top._key)
+            return true;
+        _openList.pop();
+    }
+    return false;
+}
+
+PathReplanner::SearchResult PathReplanner::computePath(std::vector<BoostPoint>& pathWay)
+{
+    BT_PRE_CONDITION(!isNull());            // DEV Issue: Need to call initialize before
+    BT_PRE_CONDITION(pathWay.empty());      // DEV Issue: Need an empty result!
+
+    SearchResult result{ false, 0, 0.0f };
+
+    // Parse only if inside same sub-graph (else never solution so don't waste time)
+    const TerrainGraph& graph = _profile->getWorld().getGraph();
+    if(graph.getSubgraphID(_start) != graph.getSubgraphID(_goal))
+        return result;
+
+    // Repair until start is consistent and no open node can improve it
+    while(skipOldEntries())
+    {
+        const OpenNode current = _openList.top();
+        if(!(current._key < computeKey(_start)) && _rhs[_start] == _g[_start])
+            break;
+
+        _openList.pop();
+        _isOpen[current._node] = false;
+        ++result._nbExpansions;
+
+        const Key key = computeKey(current._node);
+        if(current._key < key)
+        {
+            // Start moved: key was too low
+            _keys[current._node]   = key;
+            _isOpen[current._node] = true;
+            _openList.push({ key, current._node });
+        }
+        else if(_g[current._node] > _rhs[current._node])
+        {
+            _g[current._node] = _rhs[current._node];
+            for(EdgeID edge = graph.beginEdge(current._node); edge != graph.endEdge(current._node); ++edge)
+            {
+                updateNode(graph.getTarget(edge));
+            }
+        }
+        else
+        {
+            _g[current._node] = std::numeric_limits<CostType>::infinity();
+            updateNode(current._node);
+            for(EdgeID edge = graph.beginEdge(current._node); edge != graph.endEdge(current._node); ++edge)
+            {
+                updateNode(graph.getTarget(edge));
+            }
+        }
+    }
+
+    if(_g[_start] == std::numeric_limits<CostType>::infinity())
+        return result;
+
+    // Follow best successor from start to goal
+    NodeID node = _start;
+    pathWay.emplace_back(graph.getCentroid(node));
+    while(node != _goal)
+    {
+        EdgeID   bestEdge = graph.endEdge(node);
+        CostType bestCost = std::numeric_limits<CostType>::infinity();
+        for(EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+        {
+            const CostType cost = _profile->getWeight(edge) + _g[graph.getTarget(edge)];
+            if(cost < bestCost)
+            {
+                bestCost = cost;
+                bestEdge = edge;
+            }
+        }
+        BT_ASSERT(bestEdge != graph.endEdge(node));          // DEV Issue: Search is not consistent !
+        BT_ASSERT(pathWay.size() <= graph.getNbNodes());     // DEV Issue: Cycle into path !
+
+        result._cost += _profile->getWeight(bestEdge);
+        node = graph.getTarget(bestEdge);
+        pathWay.emplace_back(graph.getCentroid(node));
+    }
+    std::reverse(pathWay.begin(), pathWay.end());
+
+    result._found = true;
+    return result;
+}
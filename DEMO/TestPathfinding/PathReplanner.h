@@ -0,0 +1,165 @@
+#pragma once
+
+#include "PathWorld.h"
+
+class WeightProfile;
+
+//----------------------------------------------------------------------------
+/// \brief Incremental replanner of one agent (D* Lite).
+/// Search goes from goal to agent and keeps g/rhs of each node, so when
+/// weights change only inconsistent nodes around changed edges are repaired.
+/// Agent can move along path: keys are shifted (km) instead of rebuilt.
+/// \code{ .cpp }
+///     PathReplanner planner;
+///     planner.initialize(profile, start, goal);
+///     planner.computePath(pathWay);
+///     profile.setWeight(edge, std::numeric_limits<float>::infinity());
+///     planner.updateEdges({ edge });
+///     planner.moveTo(position);
+///     planner.computePath(pathWay);
+/// \endcode
+/// \note One planner by agent: weights are read from shared profile (see WeightProfile::setWeight()).
+class PathReplanner final
+{
+    BT_NOCOPY_NOMOVE(PathReplanner);
+
+    public:
+        using NodeID       = PathWorld::WalkTerrainID;
+        using EdgeID       = PathWorld::TerrainEdgeID;
+        using CostType     = PathWorld::CostType;
+        using SearchResult = PathWorld::SearchResult;
+
+        /// Constructor
+        PathReplanner():
+        _profile(nullptr), _start(0), _goal(0), _last(0), _keyModifier(0.0f)
+        {}
+
+        /// Destructor
+        ~PathReplanner()
+        {
+            BT_POST_CONDITION(isNull());    // DEV Issue: Call release() !
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Prepare search state (search runs on first computePath()).
+        ///
+        /// \param[in] profile: weights of agent (must live longer than planner).
+        /// \param[in] start: position of agent.
+        /// \param[in] goal: destination.
+        void initialize(const WeightProfile& profile, const NodeID start, const NodeID goal);
+
+        //------------------------------------------------------------------------
+        /// \brief  Release all data.
+        ///
+        void release();
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if planner is initialized.
+        ///
+        /// \returns True if null, false otherwise.
+        bool isNull() const
+        {
+            return _profile == nullptr;
+        }
+
+        NodeID getStart() const
+        {
+            return _start;
+        }
+
+        NodeID getGoal() const
+        {
+            return _goal;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Agent moved: next path starts from this node.
+        ///
+        /// \param[in] start: new position of agent.
+        void moveTo(const NodeID start);
+
+        //------------------------------------------------------------------------
+        /// \brief  Weight of edges changed into profile: mark their source as inconsistent.
+        ///
+        /// \param[in] edges: changed edges.
+        void updateEdges(const std::vector<EdgeID>& edges);
+
+        //------------------------------------------------------------------------
+        /// \brief  Cost of nodes changed (all edges around): mark them and neighbors as inconsistent.
+        ///
+        /// \param[in] nodes: changed nodes.
+        void updateNodes(const std::vector<NodeID>& nodes);
+
+        //------------------------------------------------------------------------
+        /// \brief  Repair search then read best path from start.
+        ///
+        /// \param[out] pathWay: centroid of each node from goal to start.
+        /// \returns Goal found, number of examined nodes by repair and cost of path.
+        SearchResult computePath(std::vector<BoostPoint>& pathWay);
+
+    private:
+        //----------------------------------------------------------------------------
+        /// \brief Priority of node (lexicographic order).
+        struct Key
+        {
+            CostType    _first;     ///< min(g, rhs) + h + km.
+            CostType    _second;    ///< min(g, rhs).
+
+            bool operator<(const Key& other) const
+            {
+                return _first < other._first || (_first == other._first && _second < other._second);
+            }
+
+            bool operator==(const Key& other) const
+            {
+                return _first == other._first && _second == other._second;
+            }
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief Entry of open list (lazy deletion: entry is valid if key is still the one of node).
+        struct OpenNode
+        {
+            Key     _key;       ///< Priority when pushed.
+            NodeID  _node;      ///< Inconsistent node.
+
+            /// Min-heap order
+            bool operator>(const OpenNode& other) const
+            {
+                return other._key < _key;
+            }
+        };
+
+        //------------------------------------------------------------------------
+        /// \brief  Admissible estimation from start to node.
+        ///
+        /// \param[in] node: current node.
+        /// \returns Lower bound of cost.
+        CostType estimate(const NodeID node) const;
+
+        Key computeKey(const NodeID node) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Recompute rhs of node from its successors then update open list.
+        ///
+        /// \param[in] node: node to check.
+        void updateNode(const NodeID node);
+
+        //------------------------------------------------------------------------
+        /// \brief  Pop node with lowest valid key (skip old entries).
+        ///
+        /// \returns False if open list is empty.
+        bool skipOldEntries();
+
+        const WeightProfile*    _profile;       ///< [LINK] Weights of agent. WARNING: No destruction.
+        NodeID                  _start;         ///< Position of agent.
+        NodeID                  _goal;          ///< Destination.
+        NodeID                  _last;          ///< Start of last key modifier update.
+        CostType                _keyModifier;   ///< km: sum of heuristic shift when agent moves.
+
+        std::vector<CostType>   _g;             ///< [OWNERSHIP] Cost to goal of each node (expanded).
+        std::vector<CostType>   _rhs;           ///< [OWNERSHIP] One step lookahead of g.
+        std::vector<Key>        _keys;          ///< [OWNERSHIP] Key of node into open list.
+        std::vector<bool>       _isOpen;        ///< [OWNERSHIP] Node is into open list.
+        std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> _openList;    ///< [OWNERSHIP] Inconsistent nodes.
+};
@@ -0,0 +1,316 @@
+#include "PathScheduler.h"
+
+const size_t PathScheduler::_nbPriorities;
+
+PathScheduler::PathScheduler(const PathWorld& world, const size_t nbWorkers):
+_metrics(), _nbArrivals(0), _maxInFlight(0), _isPaused(false), _stop(false), _service(world, nbWorkers)
+{
+    // Player requests are never refused: only AI classes are bounded
+    _maxPending[static_cast<size_t>(Priority::Critical)]   = std::numeric_limits<size_t>::max();
+    _maxPending[static_cast<size_t>(Priority::Normal)]     = 4096;
+    _maxPending[static_cast<size_t>(Priority::Background)] = 1024;
+
+    // Workers never have queued request: order is decided at dispatch
+    _maxInFlight = _service.getNbWorkers();
+}
+
+PathScheduler::~PathScheduler()
+{
+    std::vector<Waiter> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        for(const auto& pending : _pending)
+        {
+            auto found = _entries.find(pending.second);
+            std::move(found->second->_waiters.begin(), found->second->_waiters.end(), std::back_inserter(cancelled));
+            _entries.erase(found);
+        }
+        _pending.clear();
+        _metrics._queueDepth.fill(0);
+    }
+
+    answer(cancelled, PathResponse(PathResponse::Status::Cancelled));
+    // Destructor of service cancels running searches (onFinished() answers their callers)
+}
+
+void PathScheduler::setAdmission(const Priority priority, const size_t maxPending)
+{
+    BT_PRE_CONDITION(priority < Priority::NbPriorities);    // DEV Issue: Invalid class !
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxPending[static_cast<size_t>(priority)] = maxPending;
+}
+
+void PathScheduler::pause()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isPaused = true;
+}
+
+void PathScheduler::resume()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isPaused = false;
+    }
+    dispatch();
+}
+
+PathFuture PathScheduler::submitPath(const PathRequest& request, const Priority priority, Callback callback)
+{
+    BT_PRE_CONDITION(request._agent != nullptr);            // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(priority < Priority::NbPriorities);    // DEV Issue: Invalid class !
+
+    const Clock::time_point now = Clock::now();
+    const size_t classID = static_cast<size_t>(priority);
+
+    std::vector<Waiter> refused(1);
+    Waiter& waiter = refused.front();
+    waiter._callback = std::move(callback);
+    waiter._deadline = request._deadline;
+    waiter._token    = request._token;
+    const PathFuture future(waiter._promise.get_future().share(), request._token);
+
+    PathResponse::Status status = PathResponse::Status::Found;
+    std::vector<Waiter> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_metrics._nbSubmitted;
+
+        // Same key as path cache: agents of same profile share search
+        const RequestKey key(request._from, request._to, request._speedMode ? 0 : PathCache::hashSpeed(request._agent->getNavigation()._speed), request._speedMode);
+        auto found = _entries.find(key);
+        if(request._token.isCancelled())
+        {
+            status = PathResponse::Status::Cancelled;
+        }
+        else if(found != _entries.end())
+        {
+            // Same search is pending or running: wait for it
+            Entry& entry = *found->second;
+            ++_metrics._nbCoalesced;
+            cancelled = takeCancelled(entry);
+            if(!entry._isRunning)
+            {
+                // Entry lives until its last caller deadline, runs at most urgent caller rank
+                entry._request._deadline = std::max(entry._request._deadline, request._deadline);
+                const OrderKey order(std::min(std::get<0>(entry._order), classID), std::min(std::get<1>(entry._order), request._deadline), std::get<2>(entry._order));
+                if(order != entry._order)
+                {
+                    _pending.erase(entry._order);
+                    --_metrics._queueDepth[std::get<0>(entry._order)];
+                    entry._order = order;
+                    _pending.emplace(order, key);
+                    ++_metrics._queueDepth[std::get<0>(order)];
+                }
+            }
+            entry._waiters.emplace_back(std::move(waiter));
+            refused.clear();
+        }
+        else if(now > request._deadline)
+        {
+            status = PathResponse::Status::Expired;
+        }
+        else if(_metrics._queueDepth[classID] >= _maxPending[classID])
+        {
+            status = PathResponse::Status::Rejected;
+            ++_metrics._nbRejected;
+        }
+        else
+        {
+            auto entry = std::make_unique<Entry>(request);
+            Entry* search = entry.get();
+            // Search stops only when all callers are cancelled
+            entry->_request._token = CancelToken([this, search]() { return isAbandoned(*search); });
+            entry->_order          = OrderKey(classID, request._deadline, _nbArrivals++);
+            entry->_submitted      = now;
+            entry->_waiters.emplace_back(std::move(waiter));
+            _pending.emplace(entry->_order, key);
+            _entries.emplace(key, std::move(entry));
+            refused.clear();
+
+            ++_metrics._queueDepth[classID];
+            _metrics._maxQueueDepth = std::max(_metrics._maxQueueDepth, _pending.size());
+        }
+    }
+
+    answer(cancelled, PathResponse(PathResponse::Status::Cancelled));
+    if(!refused.empty())
+    {
+        // Waiter is still here: answer now
+        answer(refused, PathResponse(status));
+        return future;
+    }
+
+    dispatch();
+    return future;
+}
+
+PathScheduler::Metrics PathScheduler::getMetrics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _metrics;
+}
+
+void PathScheduler::dispatch()
+{
+    while(true)
+    {
+        std::vector<Waiter>             dropped;
+        PathResponse::Status            status = PathResponse::Status::Cancelled;
+        std::unique_ptr<PathRequest>    request;
+        RequestKey                      key;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if(_stop || _isPaused || _pending.empty() || _metrics._nbInFlight >= _maxInFlight)
+                return;
+
+            // Most urgent class, then earliest deadline, then oldest
+            auto best = _pending.begin();
+            key = best->second;
+            _pending.erase(best);
+
+            auto found = _entries.find(key);
+            Entry& entry = *found->second;
+            const size_t classID = std::get<0>(entry._order);
+            --_metrics._queueDepth[classID];
+
+            dropped = takeCancelled(entry);
+            const Clock::time_point now = Clock::now();
+            if(entry._waiters.empty() || now > entry._request._deadline)
+            {
+                // Every caller is cancelled or late: never computed
+                status = entry._waiters.empty() ? PathResponse::Status::Cancelled : PathResponse::Status::Expired;
+                std::move(entry._waiters.begin(), entry._waiters.end(), std::back_inserter(dropped));
+                _entries.erase(found);
+            }
+            else
+            {
+                entry._isRunning = true;
+                ++_metrics._nbInFlight;
+
+                const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(now - entry._submitted);
+                ++_metrics._nbDispatched[classID];
+                _metrics._totalWait[classID] += wait;
+                _metrics._maxWait[classID]    = std::max(_metrics._maxWait[classID], wait);
+                request = std::make_unique<PathRequest>(entry._request);
+            }
+        }
+
+        // Cancelled callers receive Cancelled whatever status is
+        answer(dropped, PathResponse(status));
+        if(!request)
+            continue;
+        // Outside lock: callback can be called now by service
+        _service.submitPath(*request, [this, key](const PathResponse& response) { onFinished(key, response); });
+    }
+}
+
+std::vector<PathScheduler::Waiter> PathScheduler::takeCancelled(Entry& entry)
+{
+    std::vector<Waiter> cancelled;
+    auto end = std::stable_partition(entry._waiters.begin(), entry._waiters.end(), [](const Waiter& waiter) { return !waiter._token.isCancelled(); });
+    std::move(end, entry._waiters.end(), std::back_inserter(cancelled));
+    entry._waiters.erase(end, entry._waiters.end());
+    return cancelled;
+}
+
+bool PathScheduler::isAbandoned(Entry& entry)
+{
+    std::vector<Waiter> cancelled;
+    bool isEmpty = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        cancelled = takeCancelled(entry);
+        isEmpty   = entry._waiters.empty();
+    }
+
+    answer(cancelled, PathResponse(PathResponse::Status::Cancelled));
+    return isEmpty;
+}
+
+void PathScheduler::answer(std::vector<Waiter>& waiters, const PathResponse& response)
+{
+    if(waiters.empty())
+        return;
+
+    // Token can change while answering: read it once
+    const Clock::time_point now = Clock::now();
+    std::vector<bool> isCancelled(waiters.size());
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for(size_t waiterID = 0; waiterID < waiters.size(); ++waiterID)
+        {
+            isCancelled[waiterID] = response._status == PathResponse::Status::Cancelled || waiters[waiterID]._token.isCancelled();
+            if(!isCancelled[waiterID] && (response._status == PathResponse::Status::Expired || now > waiters[waiterID]._deadline))
+            {
+                ++_metrics._nbMissedDeadlines;
+            }
+        }
+    }
+
+    const PathResponse cancelled(PathResponse::Status::Cancelled);
+    for(size_t waiterID = 0; waiterID < waiters.size(); ++waiterID)
+    {
+        const PathResponse& result = isCancelled[waiterID] ? cancelled : response;
+        if(waiters[waiterID]._callback)
+        {
+            waiters[waiterID]._callback(result);
+        }
+        waiters[waiterID]._promise.set_value(result);
+    }
+}
+
+void PathScheduler::onFinished(const RequestKey& key, const PathResponse& response)
+{
+    std::vector<Waiter> finished;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        --_metrics._nbInFlight;
+
+        auto found = _entries.find(key);
+        BT_ASSERT(found != _entries.end());     // DEV Issue: Entry removed while running !
+        Entry& entry = *found->second;
+
+        std::vector<Waiter> survivors;
+        if(!_stop && (response._status == PathResponse::Status::Expired || response._status == PathResponse::Status::Cancelled))
+        {
+            // Callers coalesced after search stopped (later deadline, not cancelled) wait again
+            const Clock::time_point now = Clock::now();
+            for(auto& waiter : entry._waiters)
+            {
+                const bool isStopped = response._status == PathResponse::Status::Expired ? now > waiter._deadline : waiter._token.isCancelled();
+                (isStopped ? finished : survivors).emplace_back(std::move(waiter));
+            }
+        }
+        else
+        {
+            finished = std::move(entry._waiters);
+        }
+
+        if(survivors.empty())
+        {
+            _entries.erase(found);
+        }
+        else
+        {
+            Clock::time_point first = Clock::time_point::max();
+            Clock::time_point last  = Clock::time_point::min();
+            for(const auto& waiter : survivors)
+            {
+                first = std::min(first, waiter._deadline);
+                last  = std::max(last, waiter._deadline);
+            }
+            entry._waiters           = std::move(survivors);
+            entry._isRunning         = false;
+            entry._request._deadline = last;
+            entry._order             = OrderKey(std::get<0>(entry._order), first, _nbArrivals++);
+            _pending.emplace(entry._order, key);
+            ++_metrics._queueDepth[std::get<0>(entry._order)];
+        }
+    }
+
+    answer(finished, response);
+    dispatch();
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "PathService.h"
+
+//----------------------------------------------------------------------------
+/// \brief Priority and deadline aware front of PathService.
+/// Pending requests are ordered by priority class then earliest deadline
+/// (EDF) and only given to workers when one is free, so a late critical
+/// request passes before queued background ones. Same (from, to, navigation
+/// profile, speed mode) request already pending or running is coalesced, even
+/// from other agents: one search answers all callers. Each class has a maximum number of pending requests
+/// (admission control) and request whose deadline passed is dropped.
+/// \code{ .cpp }
+///     PathScheduler scheduler(world, 2);
+///     PathFuture future = scheduler.submitPath(PathRequest(agent, from, to), PathScheduler::Priority::Critical);
+/// \endcode
+/// \note Each caller keeps its own token: cancelled caller is answered alone,
+/// shared search stops only when all its callers are cancelled.
+class PathScheduler final
+{
+    BT_NOCOPY_NOMOVE(PathScheduler);
+
+    public:
+        using Clock    = PathRequest::Clock;
+        using Callback = PathService::Callback;
+
+        /// Class of request (lower value runs first).
+        enum class Priority
+        {
+            Critical,   ///< Player controlled units: needed in current frame.
+            Normal,     ///< Gameplay AI.
+            Background, ///< Can wait (precomputation, idle agents).
+            NbPriorities
+        };
+        static const size_t _nbPriorities = static_cast<size_t>(Priority::NbPriorities);
+
+        //----------------------------------------------------------------------------
+        /// \brief Counters of scheduler (snapshot, see getMetrics()).
+        struct Metrics
+        {
+            std::array<size_t, _nbPriorities>               _queueDepth;    ///< Pending requests by class.
+            std::array<size_t, _nbPriorities>               _nbDispatched;  ///< Requests given to workers by class.
+            std::array<std::chrono::microseconds, _nbPriorities> _totalWait; ///< Sum of time between submit and dispatch by class.
+            std::array<std::chrono::microseconds, _nbPriorities> _maxWait;   ///< Longest time between submit and dispatch by class.
+            size_t  _maxQueueDepth;     ///< Highest number of pending requests.
+            size_t  _nbInFlight;        ///< Requests computed by workers now.
+            size_t  _nbSubmitted;       ///< Calls of submitPath().
+            size_t  _nbCoalesced;       ///< Calls answered by search of another call.
+            size_t  _nbRejected;        ///< Calls refused by admission control.
+            size_t  _nbMissedDeadlines; ///< Calls answered after their deadline (or dropped).
+
+            //------------------------------------------------------------------------
+            /// \brief  Get mean wait of class.
+            ///
+            /// \param[in] priority: class.
+            /// \returns Mean time between submit and dispatch (0 if nothing dispatched).
+            std::chrono::microseconds getMeanWait(const Priority priority) const
+            {
+                const size_t classID = static_cast<size_t>(priority);
+                return _nbDispatched[classID] == 0 ? std::chrono::microseconds(0) : _totalWait[classID] / static_cast<std::chrono::microseconds::rep>(_nbDispatched[classID]);
+            }
+        };
+
+        //------------------------------------------------------------------------
+        /// \brief  Constructor: start workers.
+        ///
+        /// \param[in] world: initialized world (must live longer than scheduler).
+        /// \param[in] nbWorkers: number of threads (0 = hardware concurrency).
+        PathScheduler(const PathWorld& world, const size_t nbWorkers = 0);
+
+        /// Destructor: cancel pending requests then stop workers.
+        ~PathScheduler();
+
+        //------------------------------------------------------------------------
+        /// \brief  Set admission control of class.
+        ///
+        /// \param[in] priority: class.
+        /// \param[in] maxPending: maximum number of pending requests (others are rejected).
+        void setAdmission(const Priority priority, const size_t maxPending);
+
+        //------------------------------------------------------------------------
+        /// \brief  Hold dispatch (level loading, frame spike): requests keep queuing.
+        ///
+        void pause();
+
+        //------------------------------------------------------------------------
+        /// \brief  Restart dispatch after pause().
+        ///
+        void resume();
+
+        //------------------------------------------------------------------------
+        /// \brief  Queue or coalesce request (never blocks).
+        ///
+        /// \param[in] request: path to compute.
+        /// \param[in] priority: class of request.
+        /// \param[in] callback: if set, called with response (before future is ready).
+        /// \returns Future of response (ready with Rejected, Expired or Cancelled status if refused).
+        PathFuture submitPath(const PathRequest& request, const Priority priority = Priority::Normal, Callback callback = Callback());
+
+        //------------------------------------------------------------------------
+        /// \brief  Get copy of counters.
+        ///
+        /// \returns Metrics at call time.
+        Metrics getMetrics() const;
+
+    private:
+        using RequestKey = std::tuple<PathWorld::WalkTerrainID, PathWorld::WalkTerrainID, BT::uint64, bool>;  ///< From, to, hash of profile (0 in speed mode), speed mode.
+        using OrderKey   = std::tuple<size_t, Clock::time_point, BT::uint64>;    ///< Class, earliest deadline, arrival.
+
+        //----------------------------------------------------------------------------
+        /// \brief Caller waiting for response.
+        struct Waiter
+        {
+            std::promise<PathResponse>  _promise;   ///< Output.
+            Callback                    _callback;  ///< Optional notification.
+            Clock::time_point           _deadline;  ///< Deadline of this caller.
+            CancelToken                 _token;     ///< Token of this caller.
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief One search answering all callers with same key.
+        struct Entry
+        {
+            std::unique_ptr<Agent>  _agent;     ///< [OWNERSHIP] Profile of search (callers can release their agent).
+            PathRequest             _request;   ///< First request (own agent, deadline is latest one of callers, token of search).
+            OrderKey                _order;     ///< Position into pending list.
+            Clock::time_point       _submitted; ///< Arrival of first caller.
+            std::vector<Waiter>     _waiters;   ///< All callers.
+            bool                    _isRunning; ///< Given to worker.
+
+            /// Constructor
+            Entry(const PathRequest& request):
+            _agent(std::make_unique<Agent>(request._agent->getNavigation())), _request(request), _isRunning(false)
+            {
+                _request._agent = _agent.get();
+            }
+        };
+
+        //------------------------------------------------------------------------
+        /// \brief  Give best pending requests to free workers (drop expired ones).
+        ///
+        void dispatch();
+
+        //------------------------------------------------------------------------
+        /// \brief  Remove cancelled callers of entry (lock must be taken).
+        ///
+        /// \param[in,out] entry: search.
+        /// \returns Cancelled callers.
+        static std::vector<Waiter> takeCancelled(Entry& entry);
+
+        //------------------------------------------------------------------------
+        /// \brief  Linked test of search token: answer cancelled callers.
+        ///
+        /// \param[in,out] entry: running search.
+        /// \returns True if no caller is left (search can stop).
+        bool isAbandoned(Entry& entry);
+
+        //------------------------------------------------------------------------
+        /// \brief  Answer callers (cancelled caller receives Cancelled status).
+        ///
+        /// \param[in,out] waiters: callers removed from lists.
+        /// \param[in] response: result of search.
+        void answer(std::vector<Waiter>& waiters, const PathResponse& response);
+
+        //------------------------------------------------------------------------
+        /// \brief  Worker finished entry: answer callers then dispatch next one.
+        ///
+        /// \param[in] key: key of entry.
+        /// \param[in] response: result of search.
+        void onFinished(const RequestKey& key, const PathResponse& response);
+
+        mutable std::mutex                          _mutex;         ///< Protect all data below.
+        std::map<RequestKey, std::unique_ptr<Entry>> _entries;      ///< [OWNERSHIP] Pending and running searches.
+        std::map<OrderKey, RequestKey>              _pending;       ///< Pending searches in dispatch order.
+        std::array<size_t, _nbPriorities>           _maxPending;    ///< Admission control by class.
+        Metrics                                     _metrics;       ///< Counters.
+        BT::uint64                                  _nbArrivals;    ///< Arrival counter (FIFO between same deadlines).
+        size_t                                      _maxInFlight;   ///< Number of workers.
+        bool                                        _isPaused;      ///< Dispatch held.
+        bool                                        _stop;          ///< Destructor called.
+        PathService                                 _service;       ///< Workers (last member: destroyed first).
+};
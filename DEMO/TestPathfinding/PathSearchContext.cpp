@@ -0,0 +1,112 @@
+#include "PathSearchContext.h"
+
+void PathSearchContext::prepare(const size_t nbNodes)
+{
+    BT_PRE_CONDITION(nbNodes > 0);  // DEV Issue: Empty graph !
+
+    // New nodes are never stamped with current or future generation
+    if(_nodes.size() < nbNodes)
+    {
+        _nodes.resize(nbNodes, NodeState{ 0, 0.0f, 0 });
+    }
+
+    // Stamp overflow: only case where we need to clean memory
+    ++_generation;
+    if(_generation == 0)
+    {
+        for(auto& node : _nodes)
+        {
+            node._generation = 0;
+        }
+        _generation = 1;
+    }
+
+    // Keep capacity of previous queries
+    _openList.clear();
+    if(_openListType == OpenListType::RadixHeap)
+    {
+        for(auto& bucket : _buckets)
+        {
+            bucket.clear();
+        }
+    }
+    else if(_openListType == OpenListType::Bucket)
+    {
+        // Buckets below last popped key are already empty
+        for(Key key = _lastKey; key <= _highestKey; ++key)
+        {
+            _buckets[key].clear();
+        }
+    }
+    _lastKey    = 0;
+    _highestKey = 0;
+    _nbOpen     = 0;
+    _hasOrigin  = false;
+
+    BT_POST_CONDITION(_nodes.size() >= nbNodes);
+}
+
+const size_t PathSearchContext::_nbRadixBuckets;
+const PathSearchContext::Key PathSearchContext::_maxBucketKey;
+
+void PathSearchContext::setOpenList(const OpenListType type, const CostType quantum)
+{
+    BT_PRE_CONDITION(quantum > 0.0f);   // DEV Issue: Invalid quantum !
+
+    _openListType = type;
+    _quantum      = quantum;
+    _openList.clear();
+    _buckets.clear();
+    _buckets.resize(type == OpenListType::RadixHeap ? _nbRadixBuckets : (type == OpenListType::Bucket ? 1 : 0));
+    _lastKey    = 0;
+    _highestKey = 0;
+    _nbOpen     = 0;
+    _hasOrigin  = false;
+
+    if(_reverse)
+    {
+        _reverse->setOpenList(type, quantum);
+    }
+}
+
+void PathSearchContext::refillRadix()
+{
+    BT_PRE_CONDITION(_nbOpen > 0 && _buckets.front().empty());  // DEV Issue: Nothing to refill !
+
+    // Lowest non-empty bucket holds all lowest keys
+    size_t bucketID = 1;
+    while(_buckets[bucketID].empty())
+    {
+        ++bucketID;
+    }
+    std::vector<OpenNode>& bucket = _buckets[bucketID];
+    Key minKey = std::numeric_limits<Key>::max();
+    for(const OpenNode& entry : bucket)
+    {
+        minKey = std::min(minKey, getKey(entry._estimation));
+    }
+
+    // Each entry goes to lower bucket (difference with new key has less bits)
+    _lastKey = minKey;
+    for(const OpenNode& entry : bucket)
+    {
+        _buckets[getRadixBucket(getKey(entry._estimation))].push_back(entry);
+    }
+    bucket.clear();
+}
+
+PathSearchContext& PathSearchContext::getThreadContext()
+{
+    thread_local PathSearchContext context;
+    return context;
+}
+
+PathSearchContext& PathSearchContext::getReverse()
+{
+    if(!_reverse)
+    {
+        _reverse = std::make_unique<PathSearchContext>();
+        _reverse->setOpenList(_openListType, _quantum);
+    }
+    return *_reverse;
+}
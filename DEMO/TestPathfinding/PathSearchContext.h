@@ -0,0 +1,408 @@
+#pragma once
+
+#include "Define.h"
+
+//----------------------------------------------------------------------------
+/// \brief Workspace of A* search: predecessor, cost and open list storage.
+/// Memory is kept between queries and a generation stamp marks which node
+/// belongs to current query, so nothing is cleared when a new search starts.
+/// Open list is a binary heap by default: radix heap and bucket queue order
+/// estimations quantized by a step, so they are exact only up to this step.
+/// Both are monotone: entry lower than last popped key (inconsistent heuristic)
+/// goes to a small binary heap examined first.
+/// \note One context by thread: never share it between concurrent searches.
+/// \code{ .cpp }
+///     PathSearchContext context;
+///     world.computePath(agent, from, to, pathWay, context);
+/// \endcode
+class PathSearchContext final
+{
+    BT_NOCOPY(PathSearchContext);
+
+    public:
+        using NodeID     = BT::uint32;      ///< Same as PathWorld::WalkTerrainID.
+        using CostType   = float;           ///< Same as PathWorld::CostType.
+        using Generation = BT::uint32;      ///< Query stamp.
+        using Key        = BT::uint32;      ///< Quantized estimation (radix heap and bucket queue).
+
+        static const size_t _nbRadixBuckets = 33;       ///< One bucket by bit length of key difference.
+        static const Key    _maxBucketKey   = 1 << 20;  ///< Limit of bucket queue (higher keys share last bucket).
+
+        /// Policy of open list.
+        enum class OpenListType
+        {
+            BinaryHeap,     ///< std heap on float estimation.
+            QuaternaryHeap, ///< 4-ary heap on float estimation (half depth of binary heap).
+            RadixHeap,      ///< Monotone radix heap on quantized estimation.
+            Bucket          ///< Bucket queue: one bucket by quantum.
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief Entry of open list (lazy deletion: old entries are skipped when popped).
+        struct OpenNode
+        {
+            CostType    _estimation;    ///< Cost from start + heuristic to goal.
+            CostType    _cost;          ///< Cost from start when pushed.
+            NodeID      _node;          ///< Node to examine.
+
+            /// Min-heap order
+            bool operator>(const OpenNode& other) const
+            {
+                return _estimation > other._estimation;
+            }
+        };
+
+        /// Constructor
+        PathSearchContext():
+        _generation(0), _openListType(OpenListType::BinaryHeap), _quantum(1.0f), _origin(0.0f), _lastKey(0), _highestKey(0), _nbOpen(0), _hasOrigin(false)
+        {}
+
+        PathSearchContext(PathSearchContext&&) = default;
+        PathSearchContext& operator=(PathSearchContext&&) = default;
+
+        /// Destructor
+        ~PathSearchContext() = default;
+
+        //------------------------------------------------------------------------
+        /// \brief  Get context owned by calling thread (created on first call).
+        ///
+        /// \returns Context of current thread.
+        static PathSearchContext& getThreadContext();
+
+        //------------------------------------------------------------------------
+        /// \brief  Get workspace of backward side for bidirectional search (created on first call).
+        ///
+        /// \returns Context of backward search.
+        PathSearchContext& getReverse();
+
+        //------------------------------------------------------------------------
+        /// \brief  Select open list used by next queries (also by backward side).
+        /// Number of buckets scanned by bucket queue grows with range of estimation / quantum.
+        ///
+        /// \param[in] type: policy of open list.
+        /// \param[in] quantum: step of estimation sharing one key (radix heap and bucket queue).
+        void setOpenList(const OpenListType type, const CostType quantum = 1.0f);
+
+        OpenListType getOpenListType() const
+        {
+            return _openListType;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Start a new query: grow storage if needed and invalidate previous query.
+        ///
+        /// \param[in] nbNodes: number of node into graph.
+        void prepare(const size_t nbNodes);
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if node was reached during current query.
+        ///
+        /// \param[in] node: node to check.
+        /// \returns True if reached, false otherwise.
+        bool isReached(const NodeID node) const
+        {
+            BT_PRE_CONDITION(node < _nodes.size());
+            return _nodes[node]._generation == _generation;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get cost from start to node (infinity if not reached).
+        ///
+        /// \param[in] node: node to read.
+        /// \returns Cost from start.
+        CostType getCost(const NodeID node) const
+        {
+            return isReached(node) ? _nodes[node]._cost : std::numeric_limits<CostType>::infinity();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get previous node on best path (node itself for start).
+        ///
+        /// \param[in] node: reached node.
+        /// \returns Previous node.
+        NodeID getPredecessor(const NodeID node) const
+        {
+            BT_PRE_CONDITION(isReached(node));
+            return _nodes[node]._predecessor;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Register better cost for node.
+        ///
+        /// \param[in] node: reached node.
+        /// \param[in] cost: cost from start.
+        /// \param[in] predecessor: previous node on path.
+        void reach(const NodeID node, const CostType cost, const NodeID predecessor)
+        {
+            BT_PRE_CONDITION(node < _nodes.size());
+            NodeState& state = _nodes[node];
+            state._cost        = cost;
+            state._predecessor = predecessor;
+            state._generation  = _generation;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Add node into open list.
+        ///
+        /// \param[in] node: node to examine later.
+        /// \param[in] cost: cost from start.
+        /// \param[in] estimation: cost from start + heuristic.
+        void push(const NodeID node, const CostType cost, const CostType estimation)
+        {
+            switch(_openListType)
+            {
+                case OpenListType::BinaryHeap:
+                    _openList.push_back({ estimation, cost, node });
+                    std::push_heap(_openList.begin(), _openList.end(), std::greater<OpenNode>());
+                    break;
+                case OpenListType::QuaternaryHeap:
+                    _openList.push_back({ estimation, cost, node });
+                    siftUp(_openList.size() - 1);
+                    break;
+                case OpenListType::RadixHeap:
+                case OpenListType::Bucket:
+                    pushQuantized({ estimation, cost, node });
+                    break;
+            }
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Extract best node of open list.
+        ///
+        /// \returns Entry with lowest estimation.
+        OpenNode pop()
+        {
+            BT_PRE_CONDITION(!isOpenEmpty());
+            OpenNode best;
+            switch(getBestList())
+            {
+                case OpenListType::BinaryHeap:
+                    std::pop_heap(_openList.begin(), _openList.end(), std::greater<OpenNode>());
+                    best = _openList.back();
+                    _openList.pop_back();
+                    break;
+                case OpenListType::QuaternaryHeap:
+                    best = _openList.front();
+                    _openList.front() = _openList.back();
+                    _openList.pop_back();
+                    if(!_openList.empty())
+                    {
+                        siftDown(0);
+                    }
+                    break;
+                case OpenListType::RadixHeap:
+                    best = _buckets.front().back();
+                    _buckets.front().pop_back();
+                    if(--_nbOpen > 0 && _buckets.front().empty())
+                    {
+                        refillRadix();
+                    }
+                    break;
+                case OpenListType::Bucket:
+                    best = _buckets[_lastKey].back();
+                    _buckets[_lastKey].pop_back();
+                    if(--_nbOpen > 0)
+                    {
+                        while(_buckets[_lastKey].empty())
+                        {
+                            ++_lastKey;
+                        }
+                    }
+                    break;
+            }
+            return best;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Read best node of open list.
+        ///
+        /// \returns Entry with lowest estimation.
+        const OpenNode& top() const
+        {
+            BT_PRE_CONDITION(!isOpenEmpty());
+            switch(getBestList())
+            {
+                case OpenListType::RadixHeap:
+                    return _buckets.front().back();
+                case OpenListType::Bucket:
+                    return _buckets[_lastKey].back();
+                default:
+                    return _openList.front();
+            }
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if open list has no more entries.
+        ///
+        /// \returns True if empty, false otherwise.
+        bool isOpenEmpty() const
+        {
+            return _openList.empty() && _nbOpen == 0;
+        }
+
+    private:
+        //----------------------------------------------------------------------------
+        /// \brief Search data of one node (valid only when _generation matches context).
+        struct NodeState
+        {
+            NodeID      _predecessor;   ///< Previous node on best path.
+            CostType    _cost;          ///< Cost from start.
+            Generation  _generation;    ///< Query which writes this data.
+        };
+
+        //------------------------------------------------------------------------
+        /// \brief  Get structure holding best entry: entries under last key of radix heap
+        /// and bucket queue are into binary heap.
+        ///
+        /// \returns Policy to read.
+        OpenListType getBestList() const
+        {
+            const bool isQuantized = _openListType == OpenListType::RadixHeap || _openListType == OpenListType::Bucket;
+            return isQuantized && !_openList.empty() ? OpenListType::BinaryHeap : _openListType;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Move up entry of 4-ary heap until its parent is lower.
+        ///
+        /// \param[in] position: index of entry in heap.
+        void siftUp(size_t position)
+        {
+            const OpenNode entry = _openList[position];
+            while(position > 0)
+            {
+                const size_t parent = (position - 1) / 4;
+                if(!(_openList[parent] > entry))
+                    break;
+                _openList[position] = _openList[parent];
+                position = parent;
+            }
+            _openList[position] = entry;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Move down entry of 4-ary heap until its children are greater.
+        ///
+        /// \param[in] position: index of entry in heap.
+        void siftDown(size_t position)
+        {
+            const OpenNode entry = _openList[position];
+            const size_t size = _openList.size();
+            for(;;)
+            {
+                const size_t first = position * 4 + 1;
+                if(first >= size)
+                    break;
+                size_t best = first;
+                const size_t last = std::min(first + 4, size);
+                for(size_t child = first + 1; child < last; ++child)
+                {
+                    if(_openList[best] > _openList[child])
+                        best = child;
+                }
+                if(!(entry > _openList[best]))
+                    break;
+                _openList[position] = _openList[best];
+                position = best;
+            }
+            _openList[position] = entry;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Quantize estimation (higher keys share last one).
+        ///
+        /// \param[in] estimation: cost from start + heuristic (not under origin).
+        /// \returns Key of entry.
+        Key getKey(const CostType estimation) const
+        {
+            const CostType offset = (estimation - _origin) / _quantum;
+            const Key maxKey = _openListType == OpenListType::Bucket ? _maxBucketKey : std::numeric_limits<Key>::max();
+            return offset < static_cast<CostType>(maxKey) ? static_cast<Key>(offset) : maxKey;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get index of radix bucket: bit length of difference with last popped key.
+        ///
+        /// \param[in] key: key of entry (>= last popped key).
+        /// \returns Index of bucket (0 when same key).
+        size_t getRadixBucket(const Key key) const
+        {
+            Key difference = key ^ _lastKey;
+            size_t length = 0;
+            for(size_t shift = 16; shift > 0; shift /= 2)
+            {
+                if(difference >= (Key(1) << shift))
+                {
+                    difference >>= shift;
+                    length += shift;
+                }
+            }
+            return length + difference;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  First entry of query defines quantization (keys are relative to it).
+        ///
+        /// \param[in] estimation: estimation of pushed entry.
+        void setOrigin(const CostType estimation)
+        {
+            if(!_hasOrigin)
+            {
+                _origin    = estimation;
+                _hasOrigin = true;
+            }
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Add entry to radix heap or bucket queue.
+        ///
+        /// \param[in] entry: node to examine later.
+        void pushQuantized(const OpenNode& entry)
+        {
+            setOrigin(entry._estimation);
+
+            // Under last popped key: buckets can't keep order
+            const CostType offset = (entry._estimation - _origin) / _quantum;
+            if(offset < (_nbOpen == 0 ? 0.0f : static_cast<CostType>(_lastKey)))
+            {
+                _openList.push_back(entry);
+                std::push_heap(_openList.begin(), _openList.end(), std::greater<OpenNode>());
+                return;
+            }
+
+            // Empty buckets: any key can become lowest one
+            const Key key = getKey(entry._estimation);
+            if(_nbOpen++ == 0)
+            {
+                _lastKey = key;
+            }
+            if(_openListType == OpenListType::RadixHeap)
+            {
+                _buckets[getRadixBucket(key)].push_back(entry);
+                return;
+            }
+            if(key >= _buckets.size())
+            {
+                _buckets.resize(std::max<size_t>(key + 1, _buckets.size() * 2));
+            }
+            _buckets[key].push_back(entry);
+            _highestKey = std::max(_highestKey, key);
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Radix heap: move lowest entries of first non-empty bucket to bucket 0.
+        ///
+        void refillRadix();
+
+        std::vector<NodeState>  _nodes;         ///< [OWNERSHIP] State by node (indexed by NodeID).
+        std::vector<OpenNode>   _openList;      ///< [OWNERSHIP] Binary or 4-ary heap of node to examine.
+        std::vector<std::vector<OpenNode>> _buckets; ///< [OWNERSHIP] Buckets of radix heap or bucket queue.
+        std::unique_ptr<PathSearchContext> _reverse; ///< [OWNERSHIP] Backward side of bidirectional search.
+        Generation              _generation;    ///< Current query stamp.
+        OpenListType            _openListType;  ///< Policy of open list.
+        CostType                _quantum;       ///< Step of estimation by key.
+        CostType                _origin;        ///< Estimation of key 0 (first entry of query).
+        Key                     _lastKey;       ///< Key of last popped entry (monotone queue).
+        Key                     _highestKey;    ///< Highest key used by bucket queue (buckets to clear).
+        size_t                  _nbOpen;        ///< Number of entries of radix heap or bucket queue.
+        bool                    _hasOrigin;     ///< Origin of keys is set for current query.
+};
@@ -0,0 +1,133 @@
+#include "PathService.h"
+
+const BT::uint32 PathService::_sliceExpansions;
+
+PathService::PathService(const PathWorld& world, const size_t nbWorkers, const size_t capacity):
+_world(world), _queue(capacity), _nbQueued(0), _stop(false)
+{
+    BT_PRE_CONDITION(!world.isNull());  // DEV Issue: World not initialized !
+
+    const size_t nbThreads = nbWorkers > 0 ? nbWorkers : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    // Handles exist before workers start
+    _handles.resize(nbThreads);
+    _threads.reserve(nbThreads);
+    for(size_t workerID = 0; workerID < nbThreads; ++workerID)
+    {
+        _threads.emplace_back(&PathService::run, this, workerID);
+    }
+
+    BT_POST_CONDITION(getNbWorkers() == nbThreads);
+}
+
+PathService::~PathService()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeUp.notify_all();
+
+    for(auto& thread : _threads)
+    {
+        thread.join();
+    }
+
+    BT_POST_CONDITION(_nbQueued == 0);
+}
+
+PathFuture PathService::submitPath(const PathRequest& request, Callback callback)
+{
+    BT_PRE_CONDITION(request._agent != nullptr);    // DEV Issue: Invalid input !
+
+    auto job = std::make_unique<Job>(request, std::move(callback));
+    PathFuture future(job->_promise.get_future().share(), request._token);
+
+    // Counted before push: worker never decrements before it
+    ++_nbQueued;
+    if(!_queue.tryPush(std::move(job)))
+    {
+        --_nbQueued;
+        // Job is still here: answer now
+        const PathResponse response(PathResponse::Status::Rejected);
+        if(job->_callback)
+        {
+            job->_callback(response);
+        }
+        job->_promise.set_value(response);
+        return future;
+    }
+
+    // Sleeping worker checks counter under lock: never lose wake up
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _wakeUp.notify_one();
+    return future;
+}
+
+PathResponse PathService::execute(const PathRequest& request, PathWorld::SearchHandle& handle) const
+{
+    // Drop request without computing it
+    if(_stop || request._token.isCancelled())
+        return PathResponse(PathResponse::Status::Cancelled);
+    if(PathRequest::Clock::now() > request._deadline)
+        return PathResponse(PathResponse::Status::Expired);
+
+    _world.beginPath(*request._agent, request._from, request._to, handle, request._speedMode);
+    PathResponse response(PathResponse::Status::NotFound);
+    while(_world.step(handle, _sliceExpansions) == PathWorld::SearchStatus::Running)
+    {
+        if(_stop || request._token.isCancelled())
+        {
+            response._status = PathResponse::Status::Cancelled;
+            break;
+        }
+        if(PathRequest::Clock::now() > request._deadline)
+        {
+            response._status = PathResponse::Status::Expired;
+            break;
+        }
+    }
+
+    response._nbExpansions = handle.getResult()._nbExpansions;
+    if(handle.getStatus() == PathWorld::SearchStatus::Found)
+    {
+        response._status = PathResponse::Status::Found;
+        _world.result(handle, response._pathWay);
+    }
+    return response;
+}
+
+void PathService::run(const size_t workerID)
+{
+    PathWorld::SearchHandle& handle = _handles[workerID];
+    std::unique_ptr<Job> job;
+    while(true)
+    {
+        if(_queue.tryPop(job))
+        {
+            --_nbQueued;
+            const PathResponse response = execute(job->_request, handle);
+            if(job->_callback)
+            {
+                // Exception of caller code never stops worker nor loses response
+                try
+                {
+                    job->_callback(response);
+                }
+                catch(...)
+                {
+                }
+            }
+            job->_promise.set_value(response);
+            job.reset();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wakeUp.wait(lock, [&]() { return _stop || _nbQueued > 0; });
+        if(_stop && _nbQueued == 0)
+            return;
+    }
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "BoundedQueue.h"
+#include "PathWorld.h"
+
+//----------------------------------------------------------------------------
+/// \brief Shared flag to cancel requests: copies read same flag.
+class CancelToken final
+{
+    public:
+        using Linked = std::function<bool()>;
+
+        /// Constructor
+        CancelToken():
+        _flag(std::make_shared<std::atomic<bool>>(false))
+        {}
+
+        //------------------------------------------------------------------------
+        /// \brief  Constructor: token also cancelled when linked test is true.
+        ///
+        /// \param[in] linked: thread safe test called by each isCancelled() (search shared by many callers).
+        explicit CancelToken(Linked linked):
+        _flag(std::make_shared<std::atomic<bool>>(false)), _linked(std::make_shared<const Linked>(std::move(linked)))
+        {}
+
+        void cancel() const
+        {
+            _flag->store(true, std::memory_order_relaxed);
+        }
+
+        bool isCancelled() const
+        {
+            return _flag->load(std::memory_order_relaxed) || (_linked && (*_linked)());
+        }
+
+    private:
+        std::shared_ptr<std::atomic<bool>>  _flag;      ///< [OWNERSHIP] Shared by all copies.
+        std::shared_ptr<const Linked>       _linked;    ///< [OWNERSHIP] Optional test shared by all copies.
+};
+
+//----------------------------------------------------------------------------
+/// \brief Input of asynchronous path (time-sliced A*, see PathWorld::beginPath()).
+struct PathRequest
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Agent*                _agent;     ///< [LINK] Who moves. WARNING: must live until future is ready.
+    PathWorld::WalkTerrainID    _from;      ///< Start node.
+    PathWorld::WalkTerrainID    _to;        ///< Goal node.
+    bool                        _speedMode; ///< Use only distance as weight.
+    Clock::time_point           _deadline;  ///< Request is dropped after this time (max = never).
+    CancelToken                 _token;     ///< Cancel request (can be shared by many requests).
+
+    /// Constructor
+    PathRequest(const Agent& agent, const PathWorld::WalkTerrainID from, const PathWorld::WalkTerrainID to, bool speedMode = false):
+    _agent(&agent), _from(from), _to(to), _speedMode(speedMode), _deadline(Clock::time_point::max())
+    {}
+};
+
+//----------------------------------------------------------------------------
+/// \brief Output of asynchronous path.
+struct PathResponse
+{
+    /// End of request.
+    enum class Status
+    {
+        Found,      ///< Path is computed.
+        NotFound,   ///< No path between nodes.
+        Cancelled,  ///< Token cancelled (or service stopped) before end.
+        Expired,    ///< Deadline passed before end (never computed if passed while queued).
+        Rejected    ///< Queue was full.
+    };
+
+    Status                  _status;        ///< End of request.
+    std::vector<BoostPoint> _pathWay;       ///< Centroid of each node from goal to start (only if found).
+    BT::uint32              _nbExpansions;  ///< Number of examined nodes.
+
+    /// Constructor
+    explicit PathResponse(const Status status = Status::Rejected):
+    _status(status), _nbExpansions(0)
+    {}
+};
+
+//----------------------------------------------------------------------------
+/// \brief Answer of PathService::submitPath(): poll it from game loop (isReady())
+/// or block on it (get()).
+class PathFuture final
+{
+    public:
+        /// Constructor
+        PathFuture() = default;
+
+        PathFuture(std::shared_future<PathResponse>&& future, const CancelToken& token):
+        _future(std::move(future)), _token(token)
+        {}
+
+        bool isValid() const
+        {
+            return _future.valid();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Check without waiting if response is available.
+        ///
+        /// \returns True if get() never blocks, false otherwise.
+        bool isReady() const
+        {
+            BT_PRE_CONDITION(isValid());
+            return _future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Wait response.
+        ///
+        /// \returns Response of worker.
+        const PathResponse& get() const
+        {
+            BT_PRE_CONDITION(isValid());
+            return _future.get();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Ask to stop request (worker stops between two steps of search).
+        ///
+        void cancel() const
+        {
+            _token.cancel();
+        }
+
+    private:
+        std::shared_future<PathResponse>    _future;    ///< Set by worker.
+        CancelToken                         _token;     ///< Same token as request.
+};
+
+//----------------------------------------------------------------------------
+/// \brief Workers computing paths of a world in background.
+/// Requests go into a bounded lock-free queue (full queue rejects request:
+/// game thread never blocks) and each worker runs time-sliced A* so token
+/// and deadline are checked between slices.
+/// \code{ .cpp }
+///     PathService service(world, 2);
+///     PathFuture future = service.submitPath(PathRequest(agent, from, to));
+///     // Later ticks
+///     if(future.isReady() && future.get()._status == PathResponse::Status::Found) { follow(future.get()._pathWay); }
+/// \endcode
+/// \note World must not be released before service.
+class PathService final
+{
+    BT_NOCOPY_NOMOVE(PathService);
+
+    public:
+        using Callback = std::function<void(const PathResponse&)>;
+
+        static const BT::uint32 _sliceExpansions = 256;    ///< Examined nodes between two checks of token and deadline.
+
+        //------------------------------------------------------------------------
+        /// \brief  Constructor: start all workers.
+        ///
+        /// \param[in] world: initialized world (must live longer than service).
+        /// \param[in] nbWorkers: number of threads (0 = hardware concurrency).
+        /// \param[in] capacity: maximum number of queued requests.
+        PathService(const PathWorld& world, const size_t nbWorkers = 0, const size_t capacity = 1024);
+
+        /// Destructor: cancel queued requests then join workers.
+        ~PathService();
+
+        size_t getNbWorkers() const
+        {
+            return _threads.size();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Queue request (never blocks).
+        ///
+        /// \param[in] request: path to compute.
+        /// \param[in] callback: if set, called by worker with response (before future is ready, exception is ignored).
+        /// \returns Future of response (ready with Rejected status if queue is full).
+        PathFuture submitPath(const PathRequest& request, Callback callback = Callback());
+
+    private:
+        //----------------------------------------------------------------------------
+        /// \brief Queued request (queue stores pointer: empty cell allocates nothing).
+        struct Job
+        {
+            PathRequest                 _request;   ///< Input.
+            std::promise<PathResponse>  _promise;   ///< Output.
+            Callback                    _callback;  ///< Optional notification.
+
+            /// Constructor
+            Job(const PathRequest& request, Callback&& callback):
+            _request(request), _callback(std::move(callback))
+            {}
+        };
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute one request (or drop it).
+        ///
+        /// \param[in] request: input.
+        /// \param[in,out] handle: search state of worker.
+        /// \returns Response.
+        PathResponse execute(const PathRequest& request, PathWorld::SearchHandle& handle) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Main loop of worker thread.
+        ///
+        /// \param[in] workerID: index of worker.
+        void run(const size_t workerID);
+
+        const PathWorld&                    _world;     ///< [LINK] World to read.
+        BT::BoundedQueue<std::unique_ptr<Job>> _queue;  ///< [OWNERSHIP] Requests waiting for worker.
+        std::vector<PathWorld::SearchHandle> _handles;  ///< [OWNERSHIP] Search state by worker.
+        std::vector<std::thread>            _threads;   ///< [OWNERSHIP] Workers.
+
+        std::mutex                          _mutex;     ///< Protect sleep/wake up.
+        std::condition_variable             _wakeUp;    ///< Signal new request or stop.
+        std::atomic<size_t>                 _nbQueued;  ///< Requests not yet taken by worker.
+        std::atomic<bool>                   _stop;      ///< Destructor called.
+};
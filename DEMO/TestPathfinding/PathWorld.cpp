@@ -1,35 +1,63 @@
 
 #include "ByteBuffer.h"
 #include "File.h"
+#include "ClusterGraph.h"
+#include "ContractionHierarchy.h"
+#include "Landmarks.h"
 #include "PathWorld.h"
+#include "ThreadPool.h"
+#include "WeightProfile.h"
 
-void PathWorld::initialize(BT::File& file)
+void PathWorld::initialize(BT::File& file, IndexType index)
 {
     BT_PRE_CONDITION(isNull());     // DEV Issue: initialize() already called !
 
     // Read graph
     loadGraph(file);
 
+    std::vector<AreaBox> areas;
+    areas.reserve(_walkTerrains.size());
+
     // Parse each node and register
-    auto walkTerrains = boost::vertices(_worldGraph);
-    auto walkTerrainID = walkTerrains.first;
-    //   Parse all
-    while(walkTerrainID != walkTerrains.second)
+    for(WalkTerrainID walkTerrainID = 0; walkTerrainID < _walkTerrains.size(); ++walkTerrainID)
     {
-        BT_ASSERT(*walkTerrainID < num_vertices(_worldGraph));
-        const auto& walkTerrain = _worldGraph[*walkTerrainID];
+        const auto& walkTerrain = _walkTerrains[walkTerrainID];
 
-        // Compute box and set inside rTree
+        // Compute box of node
         BT_ASSERT(boost::geometry::is_valid(walkTerrain._polygon));  // DEV Issue: must be valid before !
 
         // Compute bounding box
         BoostBox box;
         boost::geometry::envelope(walkTerrain._polygon, box);
 
-        // Add to rTree
-        _quadTree.insert(AreaBox(box, *walkTerrainID));
+        areas.emplace_back(box, walkTerrainID);
+    }
+
+    // Bulk load (packing): faster than insert() and less overlap between nodes
+    _quadTree = QuadTree(areas);
 
-        ++walkTerrainID;
+    _indexType = index;
+    if(index != IndexType::RTree)
+    {
+        _grid.build(areas, index == IndexType::MultiLevelGrid);
+    }
+
+    // Flatten edges of polygons
+    _edges._offsets.assign(1, 0);
+    for(const auto& walkTerrain : _walkTerrains)
+    {
+        const auto& ring = walkTerrain._polygon.outer();
+        for(size_t pointID = 0; pointID < ring.size(); ++pointID)
+        {
+            const BoostPoint& first  = ring[pointID];
+            const BoostPoint& second = ring[(pointID + 1) % ring.size()];
+            const float dy = second.get<1>() - first.get<1>();
+            _edges._x0.push_back(first.get<0>());
+            _edges._y0.push_back(first.get<1>());
+            _edges._y1.push_back(second.get<1>());
+            _edges._slope.push_back(dy != 0.0f ? (second.get<0>() - first.get<0>()) / dy : 0.0f);
+        }
+        _edges._offsets.push_back(static_cast<BT::uint32>(_edges._x0.size()));
     }
 
     BT_POST_CONDITION(!isNull());   // DEV Issue: MapFile is empty !
@@ -37,7 +65,7 @@ void PathWorld::initialize(BT::File& file)
 
 bool PathWorld::isNull() const
 {
-    return _quadTree.empty() && num_vertices(_worldGraph) == 0;
+    return _quadTree.empty() && _worldGraph.empty();
 }
 
 void PathWorld::release()
@@ -45,10 +73,25 @@ void PathWorld::release()
     BT_PRE_CONDITION(!isNull());    // DEV Issue: Need to call initialize before
 
     _quadTree.clear();
+    if(!_grid.isNull())
+    {
+        _grid.release();
+    }
+    _indexType = IndexType::RTree;
+
+    _worldGraph.clear();
 
     // Brutal replace
-    TerrainGraph empty;
-    _worldGraph = std::move(empty);
+    std::vector<WalkTerrain> empty;
+    _walkTerrains.swap(empty);
+
+    // Free workspace memory
+    _context = PathSearchContext();
+    _edges   = PolygonEdges();
+
+    // Routes and changes of old data
+    _pathCache.clear();
+    std::atomic_store(&_overlay, std::shared_ptr<const CostOverlay>());
 
     BT_POST_CONDITION(isNull());                        // DEV Issue: Clean operation failed ?
 }
@@ -56,7 +99,7 @@ void PathWorld::release()
 void PathWorld::loadGraph(BT::File& file)
 {
     BT_PRE_CONDITION(file.isOpened());
-    BT_PRE_CONDITION(num_vertices(_worldGraph) == 0); // DEV Issue: load() already called !
+    BT_PRE_CONDITION(_worldGraph.empty());            // DEV Issue: load() already called !
 
     //Read Buffer
     BT::ByteBuffer buffer;
@@ -79,9 +122,10 @@ void PathWorld::loadGraph(BT::File& file)
     BT_ASSERT(nbNode > 0);
 
     // Parse each node and create into graph
+    _walkTerrains.resize(nbNode);
     for(size_t nodeID=0; nodeID < nbNode; ++nodeID)
     {
-        WalkTerrain node;
+        WalkTerrain& node = _walkTerrains[nodeID];
         size_t terrainID=0;
         std::vector<BT::uint32> indices;
         float x, y;
@@ -106,7 +150,7 @@ void PathWorld::loadGraph(BT::File& file)
 #endif
 #endif
 
-        boost::add_vertex(node, _worldGraph);
+        _worldGraph.addNode(node._centroid, node._terrain._type, node._terrain._height, node._subgraphID);
     }
 
     // Parse each edge
@@ -127,23 +171,19 @@ void PathWorld::loadGraph(BT::File& file)
         const WalkTerrainID wtNodeId0 = static_cast<WalkTerrainID>(nodeID0);
         const WalkTerrainID wtNodeId1 = static_cast<WalkTerrainID>(nodeID1);
 
-        WalkTerrain& node0 = _worldGraph[wtNodeId0];
-        WalkTerrain& node1 = _worldGraph[wtNodeId1];
-
-        // Add edges
-        EdgeInfo info0(distance, &node0, &node1);
-        EdgeInfo info1(distance, &node1, &node0);
+        // Add edges (both directions)
+        _worldGraph.addLink(wtNodeId0, wtNodeId1, distance);
 
-        boost::add_edge(wtNodeId0, wtNodeId1, info0, _worldGraph);
-        boost::add_edge(wtNodeId1, wtNodeId0, info1, _worldGraph);
-
-        BT_ASSERT((node0._terrain._type == Ocean && node1._terrain._type == Ocean) ||
-                  (node0._terrain._type != Ocean && node1._terrain._type != Ocean)); // DEV Issue: Check valid data !
+        BT_ASSERT((_worldGraph.getType(wtNodeId0) == Ocean && _worldGraph.getType(wtNodeId1) == Ocean) ||
+                  (_worldGraph.getType(wtNodeId0) != Ocean && _worldGraph.getType(wtNodeId1) != Ocean)); // DEV Issue: Check valid data !
 
         BT_ASSERT(0.0f < distance);                               // DEV Issue: Check valid data !
     }
 
-    BT_POST_CONDITION(num_vertices(_worldGraph) > 0); // DEV Issue: Valid file !
+    // Build compact graph
+    _worldGraph.finalize();
+
+    BT_POST_CONDITION(_worldGraph.getNbNodes() > 0); // DEV Issue: Valid file !
 }
 
 PathWorld::AreaBox PathWorld::findNearest(const BoostPoint& localization) const
@@ -163,102 +203,1140 @@ PathWorld::AreaBox PathWorld::findNearest(const BoostPoint& localization) const
     throw std::exception(u8"BadPolygon");
 }
 
-float PathWorld::updateWeight(const Agent& agent, const EdgeInfo& edgeInfo) const
+bool PathWorld::locate(const BoostPoint& localization, WalkTerrainID& node) const
+{
+    if(_indexType != IndexType::RTree)
+    {
+        return _grid.query(localization, [&](WalkTerrainID candidate)
+        {
+            if(!bg::within(localization, _walkTerrains[candidate]._polygon))
+                return false;
+            node = candidate;
+            return true;
+        });
+    }
+
+    // Query visits tree without buffer: keep first polygon containing point
+    bool isFound = false;
+    const auto keepFirst = boost::make_function_output_iterator([&](const AreaBox& area)
+    {
+        node    = area.second;
+        isFound = true;
+    });
+    _quadTree.query(bgi::intersects(localization) && bgi::satisfies([&](const AreaBox& area)
+    {
+        return !isFound && bg::within(localization, getWalkTerrain(area)._polygon);
+    }), keepFirst);
+    return isFound;
+}
+
+float PathWorld::updateWeight(const Agent& agent, const WalkTerrainID from, const TerrainEdgeID edge) const
+{
+    const Agent::Navigation& navigation = agent.getNavigation();
+
+    const WalkTerrainID to = _worldGraph.getTarget(edge);
+    const Type fromType    = _worldGraph.getType(from);
+    const Type toType      = _worldGraph.getType(to);
+    BT_PRE_CONDITION(navigation._speed.at(fromType) >= 0.0f);
+    BT_PRE_CONDITION(navigation._speed.at(toType)   >= 0.0f);
+
+    const float mean = (navigation._speed.at(fromType) + navigation._speed.at(toType)) * 0.5f;
+    const float diff = BT::Maths::clamp((1000.0f + _worldGraph.getHeight(to) - _worldGraph.getHeight(from)) / 1000.0f, 0.5f, 2.0f);
+
+    //Compute weight in hour
+    return _worldGraph.getDistance(edge) / mean * diff;
+}
+
+float PathWorld::updateSpeedWeight(const TerrainEdgeID edge) const
+{
+    return _worldGraph.getDistance(edge);
+}
+
+float PathWorld::updateWeight(const Agent& agent, const WalkTerrainID from, const TerrainEdgeID edge, const CostOverlay& overlay) const
 {
     const Agent::Navigation& navigation = agent.getNavigation();
 
-    const auto& fromTerrain = edgeInfo._from->_terrain;
-    const auto& toTerrain   = edgeInfo._to->_terrain;
-    BT_PRE_CONDITION(navigation._speed.at(fromTerrain._type) >= 0.0f);
-    BT_PRE_CONDITION(navigation._speed.at(toTerrain._type)   >= 0.0f);
+    const WalkTerrainID to = _worldGraph.getTarget(edge);
+    const Type fromType    = overlay.getType(from, _worldGraph.getType(from));
+    const Type toType      = overlay.getType(to,   _worldGraph.getType(to));
+    BT_PRE_CONDITION(navigation._speed.at(fromType) >= 0.0f);
+    BT_PRE_CONDITION(navigation._speed.at(toType)   >= 0.0f);
 
-    const float mean = (navigation._speed.at(fromTerrain._type) + navigation._speed.at(toTerrain._type)) * 0.5f;
-    const float diff = BT::Maths::clamp((1000.0f + toTerrain._height - fromTerrain._height) / 1000.0f, 0.5f, 2.0f);
+    const float mean = (navigation._speed.at(fromType) + navigation._speed.at(toType)) * 0.5f;
+    const float diff = BT::Maths::clamp((1000.0f + _worldGraph.getHeight(to) - _worldGraph.getHeight(from)) / 1000.0f, 0.5f, 2.0f);
 
     //Compute weight in hour
-    return edgeInfo._distance / mean * diff;
+    return _worldGraph.getDistance(edge) / mean * diff * overlay.getFactor(edge);
+}
+
+float PathWorld::updateSpeedWeight(const TerrainEdgeID edge, const CostOverlay& overlay) const
+{
+    return _worldGraph.getDistance(edge) * overlay.getFactor(edge);
+}
+
+template<typename Change>
+void PathWorld::publishOverlay(Change change)
+{
+    BT_PRE_CONDITION(!isNull());    // DEV Issue: No data into file !
+
+    // Readers keep old snapshot until their search ends
+    std::lock_guard<std::mutex> lock(_overlayMutex);
+    const std::shared_ptr<const CostOverlay> current = getOverlay();
+    auto next = current ? std::make_shared<CostOverlay>(*current) : std::make_shared<CostOverlay>(_worldGraph.getNbNodes(), _worldGraph.getNbEdges());
+    change(*next);
+    next->setVersion(current ? current->getVersion() + 1 : 1);
+    std::atomic_store(&_overlay, std::shared_ptr<const CostOverlay>(std::move(next)));
+}
+
+void PathWorld::blockEdges(const std::vector<TerrainEdgeID>& edges)
+{
+    publishOverlay([&](CostOverlay& overlay)
+    {
+        for(const TerrainEdgeID edge : edges)
+        {
+            overlay.scaleEdge(edge, std::numeric_limits<float>::infinity());
+        }
+    });
+}
+
+void PathWorld::resetEdges(const std::vector<TerrainEdgeID>& edges)
+{
+    publishOverlay([&](CostOverlay& overlay)
+    {
+        for(const TerrainEdgeID edge : edges)
+        {
+            overlay.resetEdge(edge);
+        }
+    });
+}
+
+void PathWorld::setTerrainOverride(const std::vector<std::pair<WalkTerrainID, Type>>& terrains)
+{
+    publishOverlay([&](CostOverlay& overlay)
+    {
+        for(const auto& terrain : terrains)
+        {
+            BT_PRE_CONDITION(terrain.second == NbType || (terrain.second == Ocean) == (_worldGraph.getType(terrain.first) == Ocean)); // DEV Issue: Ocean and land are never linked !
+            overlay.setType(terrain.first, terrain.second);
+        }
+    });
+}
+
+void PathWorld::scaleRegion(const BoostBox& region, const float factor)
+{
+    std::vector<AreaBox> areas;
+    _quadTree.query(bgi::intersects(region), std::back_inserter(areas));
+
+    std::vector<WalkTerrainID> nodes;
+    nodes.reserve(areas.size());
+    for(const AreaBox& area : areas)
+    {
+        // Tree only knows envelope: keep polygon really touching region
+        if(bg::intersects(_walkTerrains[area.second]._polygon, region))
+        {
+            nodes.push_back(area.second);
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+
+    publishOverlay([&](CostOverlay& overlay)
+    {
+        for(const WalkTerrainID node : nodes)
+        {
+            for(TerrainEdgeID edge = _worldGraph.beginEdge(node); edge != _worldGraph.endEdge(node); ++edge)
+            {
+                overlay.scaleEdge(edge, factor);
+                // Inside target scales its own edge
+                if(!std::binary_search(nodes.begin(), nodes.end(), _worldGraph.getTarget(edge)))
+                {
+                    overlay.scaleEdge(_worldGraph.getReverseEdge(edge), factor);
+                }
+            }
+        }
+    });
+}
+
+void PathWorld::clearOverrides()
+{
+    publishOverlay([&](CostOverlay& overlay)
+    {
+        overlay = CostOverlay(_worldGraph.getNbNodes(), _worldGraph.getNbEdges());
+    });
+}
+
+PathWorld::CostType PathWorld::getMinCostByDistance(const Agent::Navigation& navigation, bool speedMode) const
+{
+    if(speedMode)
+    {
+        return _worldGraph.getMinDistanceRatio();
+    }
+
+    const float maxSpeed = *std::max_element(navigation._speed.begin(), navigation._speed.end());
+    return maxSpeed > 0.0f ? _worldGraph.getMinDistanceRatio() * 0.5f / maxSpeed : 0.0f;
+}
+
+template<typename WeightFunctor, typename Heuristic, typename Visitor>
+PathWorld::SearchResult PathWorld::searchAStar(PathSearchContext& context, const WalkTerrainID from, WeightFunctor weight, Heuristic heuristic, Visitor& visitor) const
+{
+    context.prepare(_worldGraph.getNbNodes());
+
+    SearchResult result{ false, 0, 0.0f };
+    context.reach(from, 0.0f, from);
+    context.push(from, 0.0f, heuristic(from));
+    stepAStar(context, weight, heuristic, visitor, std::numeric_limits<BT::uint32>::max(), result);
+    return result;
 }
 
-float PathWorld::updateSpeedWeight(const EdgeInfo& edgeInfo) const
+template<typename WeightFunctor, typename Heuristic, typename Visitor>
+void PathWorld::stepAStar(PathSearchContext& context, WeightFunctor weight, Heuristic heuristic, Visitor& visitor, const BT::uint32 maxExpansions, SearchResult& result) const
 {
-    return edgeInfo._distance;
+    BT::uint32 nbExpansions = 0;
+    while(!context.isOpenEmpty() && nbExpansions < maxExpansions)
+    {
+        const PathSearchContext::OpenNode current = context.pop();
+        // Skip entry replaced by better cost
+        if(context.getCost(current._node) < current._cost)
+            continue;
+
+        ++nbExpansions;
+        ++result._nbExpansions;
+        if(visitor.examineVertex(current._node) == VisitorStatus::Stop)
+        {
+            result._found = true;
+            result._cost  = current._cost;
+            break;
+        }
+
+        const TerrainEdgeID endEdge = _worldGraph.endEdge(current._node);
+        for(TerrainEdgeID edgeID = _worldGraph.beginEdge(current._node); edgeID != endEdge; ++edgeID)
+        {
+            const WalkTerrainID next = _worldGraph.getTarget(edgeID);
+            const CostType      cost = current._cost + weight(current._node, edgeID);
+            if(cost < context.getCost(next))
+            {
+                context.reach(next, cost, current._node);
+                context.push(next, cost, cost + heuristic(next));
+            }
+        }
+    }
 }
 
 bool PathWorld::computePath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, bool speedMode)
 {
-    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
-    BT_PRE_CONDITION(num_vertices(_worldGraph) > 0);    // DEV Issue: Valid file !
+    return computePath(agent, from, to, pathWay, _context, speedMode);
+}
 
-    BT_PRE_CONDITION(from < num_vertices(_worldGraph)); // DEV Issue: Invalid input !
-    BT_PRE_CONDITION(to   < num_vertices(_worldGraph)); // DEV Issue: Invalid input !
+bool PathWorld::computePath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, bool speedMode, SearchMode mode) const
+{
+    BT_PRE_CONDITION(pathWay.empty());                  // DEV Issue: Need an empty result!
+
+    const SearchResult result = searchPath(agent, from, to, context, speedMode, mode);
+    if(result._found)
+    {
+        extractPath(to, context, pathWay);
+    }
+    return result._found;
+}
+
+bool PathWorld::computePath(const Agent& agent, const BoostPoint& from, const BoostPoint& to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, bool speedMode, SearchMode mode) const
+{
     BT_PRE_CONDITION(pathWay.empty());                  // DEV Issue: Need an empty result!
 
-    bool valid = false;
-    const WalkTerrain& goal  = _worldGraph[to];
-    const WalkTerrain& start = _worldGraph[from];
-    BT_ASSERT(start._subgraphID != 0);
-    BT_ASSERT(goal._subgraphID != 0);
+    WalkTerrainID start = 0;
+    WalkTerrainID goal  = 0;
+    if(!locate(from, start) || !locate(to, goal))
+        return false;
 
     // Parse only if inside same sub-graph (else never solution so don't waste time)
-    if(start._subgraphID == goal._subgraphID)
+    if(_worldGraph.getSubgraphID(start) != _worldGraph.getSubgraphID(goal))
+        return false;
+
+    const SearchResult result = searchPath(agent, start, goal, context, speedMode, mode);
+    if(result._found)
     {
-        std::vector<WalkTerrainID> path(num_vertices(_worldGraph));
-        try
+        // Exact points replace centroids of extremities
+        extractPath(goal, context, pathWay);
+        pathWay.front() = to;
+        if(pathWay.size() == 1)
         {
-            if(speedMode)
+            pathWay.push_back(from);
+        }
+        pathWay.back() = from;
+    }
+    return result._found;
+}
+
+bool PathWorld::computeSmoothPath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, bool speedMode, SearchMode mode) const
+{
+    BT_PRE_CONDITION(pathWay.empty());                  // DEV Issue: Need an empty result!
+
+    const SearchResult result = searchPath(agent, from, to, context, speedMode, mode);
+    if(result._found)
+    {
+        smoothPath(to, context, pathWay);
+    }
+    return result._found;
+}
+
+bool PathWorld::computeCachedPath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, bool speedMode, SearchMode mode) const
+{
+    BT_PRE_CONDITION(pathWay.empty());                  // DEV Issue: Need an empty result!
+
+    // Same snapshot for key and search
+    const std::shared_ptr<const CostOverlay> overlay = getOverlay();
+    const CostOverlay::Version version = overlay ? overlay->getVersion() : 0;
+    const PathCache::Key key{ from, to, speedMode ? 0 : PathCache::hashSpeed(agent.getNavigation()._speed), speedMode, static_cast<BT::uint8>(mode), version };
+
+    std::vector<WalkTerrainID> nodes;
+    if(!_pathCache.find(key, nodes))
+    {
+        if(!searchWithOverlay(agent, overlay.get(), from, to, context, speedMode, mode)._found)
+        {
+            return false;
+        }
+
+        for(WalkTerrainID v = to;; v = context.getPredecessor(v))
+        {
+            nodes.emplace_back(v);
+            if(context.getPredecessor(v) == v)
+                break;
+        }
+        _pathCache.insert(key, std::vector<WalkTerrainID>(nodes));
+    }
+
+    pathWay.reserve(nodes.size());
+    for(const WalkTerrainID node : nodes)
+    {
+        pathWay.emplace_back(_worldGraph.getCentroid(node));
+    }
+    return true;
+}
+
+bool PathWorld::computePath(const ContractionHierarchy& hierarchy, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+    BT_PRE_CONDITION(&hierarchy.getWorld() == this);    // DEV Issue: Hierarchy of another world !
+    BT_PRE_CONDITION(pathWay.empty());                  // DEV Issue: Need an empty result!
+
+    return hierarchy.computePath(from, to, pathWay, context)._found;
+}
+
+bool PathWorld::computePath(const ClusterGraph& clusters, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+    BT_PRE_CONDITION(&clusters.getWorld() == this);     // DEV Issue: Hierarchy of another world !
+    BT_PRE_CONDITION(pathWay.empty());                  // DEV Issue: Need an empty result!
+
+    return clusters.computePath(from, to, pathWay, context)._found;
+}
+
+template<typename WeightFunctor>
+PathWorld::SearchResult PathWorld::searchBidirectional(PathSearchContext& context, const WalkTerrainID from, const WalkTerrainID to, WeightFunctor weight, const CostType costByDistance) const
+{
+    PathSearchContext& forward  = context;
+    PathSearchContext& backward = context.getReverse();
+    forward.prepare(_worldGraph.getNbNodes());
+    backward.prepare(_worldGraph.getNbNodes());
+
+    // Same potential for both sides (backward uses opposite) so stop test stays valid
+    const BoostPoint& startPoint = _worldGraph.getCentroid(from);
+    const BoostPoint& goalPoint  = _worldGraph.getCentroid(to);
+    const auto potential = [&](const WalkTerrainID node)
+    {
+        const BoostPoint& centroid = _worldGraph.getCentroid(node);
+        return 0.5f * costByDistance * static_cast<CostType>(bg::distance(centroid, goalPoint) - bg::distance(centroid, startPoint));
+    };
+
+    SearchResult result{ false, 0, 0.0f };
+    forward.reach(from, 0.0f, from);
+    if(from == to)
+    {
+        // Backward side must not append predecessors: goal would point after start
+        result._found = true;
+        return result;
+    }
+    forward.push(from, 0.0f, potential(from));
+    backward.reach(to, 0.0f, to);
+    backward.push(to, 0.0f, -potential(to));
+
+    CostType      best    = std::numeric_limits<CostType>::infinity();
+    WalkTerrainID meeting = from;
+    while(true)
+    {
+        const CostType minForward  = forward.isOpenEmpty()  ? std::numeric_limits<CostType>::infinity() : forward.top()._estimation;
+        const CostType minBackward = backward.isOpenEmpty() ? std::numeric_limits<CostType>::infinity() : backward.top()._estimation;
+        if(minForward + minBackward >= best)
+            break;
+
+        const bool isForward = minForward <= minBackward;
+        PathSearchContext&       side  = isForward ? forward  : backward;
+        const PathSearchContext& other = isForward ? backward : forward;
+
+        const PathSearchContext::OpenNode current = side.pop();
+        // Skip entry replaced by better cost
+        if(side.getCost(current._node) < current._cost)
+            continue;
+        ++result._nbExpansions;
+
+        const TerrainEdgeID endEdge = _worldGraph.endEdge(current._node);
+        for(TerrainEdgeID edgeID = _worldGraph.beginEdge(current._node); edgeID != endEdge; ++edgeID)
+        {
+            const WalkTerrainID next = _worldGraph.getTarget(edgeID);
+            // Backward side walks edge next -> current
+            const CostType      cost = current._cost + (isForward ? weight(current._node, edgeID) : weight(next, _worldGraph.getReverseEdge(edgeID)));
+            if(cost < side.getCost(next))
             {
-                // Compute agent weight
-                const auto weightMap = make_transform_value_property_map([&](EdgeInfo& e){ return updateSpeedWeight(e); }, get(boost::edge_bundle, _worldGraph));
-                // call astar named parameter interface
-                boost::astar_search_tree( _worldGraph, from, TerrainHeuristic(goal, _worldGraph),
-                                          boost::predecessor_map(path.data()).visitor(GoalVisitor(to)).weight_map(weightMap)
-                                        );
+                side.reach(next, cost, current._node);
+                side.push(next, cost, cost + (isForward ? potential(next) : -potential(next)));
+
+                if(other.isReached(next) && cost + other.getCost(next) < best)
+                {
+                    best    = cost + other.getCost(next);
+                    meeting = next;
+                }
             }
-            else
+        }
+    }
+
+    if(best == std::numeric_limits<CostType>::infinity())
+        return result;
+
+    // Append goal side to forward predecessors: path stays readable by extractPath()
+    for(WalkTerrainID node = meeting; backward.getPredecessor(node) != node; node = backward.getPredecessor(node))
+    {
+        const WalkTerrainID next = backward.getPredecessor(node);
+        forward.reach(next, forward.getCost(node) + backward.getCost(node) - backward.getCost(next), node);
+    }
+
+    result._found = true;
+    result._cost  = best;
+    return result;
+}
+
+bool PathWorld::isSameSubgraph(const WalkTerrainID from, const WalkTerrainID to) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+    BT_PRE_CONDITION(_worldGraph.getNbNodes() > 0);     // DEV Issue: Valid file !
+
+    BT_PRE_CONDITION(from < _worldGraph.getNbNodes());  // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(to   < _worldGraph.getNbNodes());  // DEV Issue: Invalid input !
+
+    BT_ASSERT(_worldGraph.getSubgraphID(from) != 0);
+    BT_ASSERT(_worldGraph.getSubgraphID(to) != 0);
+
+    return _worldGraph.getSubgraphID(from) == _worldGraph.getSubgraphID(to);
+}
+
+template<typename Search>
+PathWorld::SearchResult PathWorld::searchWithWeight(const Agent& agent, const CostOverlay* overlay, bool speedMode, Search search) const
+{
+    // No change: keep map weight without extra load
+    if(overlay == nullptr)
+    {
+        if(speedMode)
+        {
+            return search([&](WalkTerrainID, TerrainEdgeID e){ return updateSpeedWeight(e); });
+        }
+        return search([&](WalkTerrainID u, TerrainEdgeID e){ return updateWeight(agent, u, e); });
+    }
+
+    if(speedMode)
+    {
+        return search([&](WalkTerrainID, TerrainEdgeID e){ return updateSpeedWeight(e, *overlay); });
+    }
+    return search([&](WalkTerrainID u, TerrainEdgeID e){ return updateWeight(agent, u, e, *overlay); });
+}
+
+template<typename Heuristic>
+PathWorld::SearchResult PathWorld::searchWithHeuristic(const Agent& agent, const CostOverlay* overlay, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context, bool speedMode, Heuristic heuristic) const
+{
+    // Parse only if inside same sub-graph (else never solution so don't waste time)
+    if(!isSameSubgraph(from, to))
+    {
+        return SearchResult{ false, 0, 0.0f };
+    }
+
+    GoalVisitor visitor(to);
+    return searchWithWeight(agent, overlay, speedMode, [&](auto weight)
+    {
+        return searchAStar(context, from, weight, heuristic, visitor);
+    });
+}
+
+PathWorld::SearchResult PathWorld::searchWithOverlay(const Agent& agent, const CostOverlay* overlay, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context, bool speedMode, SearchMode mode) const
+{
+    BT_PRE_CONDITION(to < _worldGraph.getNbNodes());    // DEV Issue: Invalid input !
+
+    if(mode == SearchMode::Bidirectional)
+    {
+        // Parse only if inside same sub-graph (else never solution so don't waste time)
+        if(!isSameSubgraph(from, to))
+        {
+            return SearchResult{ false, 0, 0.0f };
+        }
+
+        // Lower factor keeps bound admissible
+        const CostType costByDistance = getMinCostByDistance(agent.getNavigation(), speedMode) * (overlay != nullptr ? overlay->getMinFactor() : 1.0f);
+        return searchWithWeight(agent, overlay, speedMode, [&](auto weight)
+        {
+            return searchBidirectional(context, from, to, weight, costByDistance);
+        });
+    }
+
+    return searchWithHeuristic(agent, overlay, from, to, context, speedMode, TerrainHeuristic(_worldGraph.getCentroid(to), _worldGraph));
+}
+
+PathWorld::SearchResult PathWorld::searchPath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context, bool speedMode, SearchMode mode) const
+{
+    // Same snapshot for whole search
+    const std::shared_ptr<const CostOverlay> overlay = getOverlay();
+    return searchWithOverlay(agent, overlay.get(), from, to, context, speedMode, mode);
+}
+
+PathWorld::SearchResult PathWorld::searchPath(const WeightProfile& profile, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context, SearchMode mode) const
+{
+    BT_PRE_CONDITION(&profile.getWorld() == this);      // DEV Issue: Profile of another world !
+    BT_PRE_CONDITION(profile.isUpToDate());             // DEV Issue: Overlay changed: rebuild profile !
+
+    // Parse only if inside same sub-graph (else never solution so don't waste time)
+    if(!isSameSubgraph(from, to))
+    {
+        return SearchResult{ false, 0, 0.0f };
+    }
+
+    const auto weight = [&](WalkTerrainID, TerrainEdgeID e){ return profile.getWeight(e); };
+    if(mode == SearchMode::Bidirectional)
+    {
+        return searchBidirectional(context, from, to, weight, profile.getMinCostByDistance());
+    }
+
+    GoalVisitor visitor(to);
+    return searchAStar(context, from, weight, TerrainHeuristic(_worldGraph.getCentroid(to), _worldGraph), visitor);
+}
+
+bool PathWorld::computePath(const WeightProfile& profile, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, SearchMode mode) const
+{
+    BT_PRE_CONDITION(pathWay.empty());                  // DEV Issue: Need an empty result!
+
+    const SearchResult result = searchPath(profile, from, to, context, mode);
+    if(result._found)
+    {
+        extractPath(to, context, pathWay);
+    }
+    return result._found;
+}
+
+PathWorld::SearchResult PathWorld::searchPath(const Agent& agent, const Landmarks& landmarks, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context) const
+{
+    BT_PRE_CONDITION(landmarks.isCompatible(*this, agent.getNavigation(), landmarks.isSpeedMode())); // DEV Issue: Landmarks of another profile !
+
+    const std::shared_ptr<const CostOverlay> overlay = getOverlay();
+    // Landmarks keep map weights: faster terrain breaks their bound, use straight distance bound
+    if(overlay && overlay->hasTypes())
+    {
+        const CostType costByDistance = getMinCostByDistance(agent.getNavigation(), landmarks.isSpeedMode()) * overlay->getMinFactor();
+        const BoostPoint& goal = _worldGraph.getCentroid(to);
+        return searchWithHeuristic(agent, overlay.get(), from, to, context, landmarks.isSpeedMode(), [&](WalkTerrainID node)
+        {
+            return costByDistance * static_cast<CostType>(bg::distance(_worldGraph.getCentroid(node), goal));
+        });
+    }
+
+    // Lower factor keeps bound admissible
+    const CostType factor = overlay ? overlay->getMinFactor() : 1.0f;
+    return searchWithHeuristic(agent, overlay.get(), from, to, context, landmarks.isSpeedMode(), [&](WalkTerrainID node) { return factor * landmarks.estimate(node, to); });
+}
+
+void PathWorld::beginPath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, SearchHandle& handle, bool speedMode) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+    BT_PRE_CONDITION(from < _worldGraph.getNbNodes() && to < _worldGraph.getNbNodes()); // DEV Issue: Invalid input !
+
+    // Same snapshot for all steps
+    handle._agent     = &agent;
+    handle._overlay   = getOverlay();
+    handle._from      = from;
+    handle._to        = to;
+    handle._speedMode = speedMode;
+    handle._result    = SearchResult{ false, 0, 0.0f };
+    handle._closest   = from;
+    handle._closestEstimation = TerrainHeuristic(_worldGraph.getCentroid(to), _worldGraph)(from);
+
+    handle._context.prepare(_worldGraph.getNbNodes());
+    handle._context.reach(from, 0.0f, from);
+
+    // Parse only if inside same sub-graph (else never solution so don't waste time)
+    if(!isSameSubgraph(from, to))
+    {
+        handle._status = SearchStatus::NotFound;
+        return;
+    }
+    handle._context.push(from, 0.0f, handle._closestEstimation);
+    handle._status = SearchStatus::Running;
+}
+
+PathWorld::SearchStatus PathWorld::step(SearchHandle& handle, const BT::uint32 maxExpansions) const
+{
+    BT_PRE_CONDITION(handle._status != SearchStatus::Idle);    // DEV Issue: Need to call beginPath before
+
+    if(handle._status != SearchStatus::Running)
+        return handle._status;
+
+    const TerrainHeuristic heuristic(_worldGraph.getCentroid(handle._to), _worldGraph);
+    ClosestVisitor visitor(handle._to, heuristic, handle._closest, handle._closestEstimation);
+    searchWithWeight(*handle._agent, handle._overlay.get(), handle._speedMode, [&](auto weight)
+    {
+        stepAStar(handle._context, weight, heuristic, visitor, maxExpansions, handle._result);
+        return handle._result;
+    });
+
+    if(handle._result._found)
+    {
+        handle._status = SearchStatus::Found;
+        // Whole path is known: partial path ends on goal too
+        handle._closest = handle._to;
+    }
+    else if(handle._context.isOpenEmpty())
+    {
+        handle._status = SearchStatus::NotFound;
+    }
+    return handle._status;
+}
+
+bool PathWorld::result(const SearchHandle& handle, std::vector<BoostPoint>& pathWay) const
+{
+    BT_PRE_CONDITION(handle._status != SearchStatus::Idle);    // DEV Issue: Need to call beginPath before
+    BT_PRE_CONDITION(pathWay.empty());                          // DEV Issue: Need an empty result!
+
+    extractPath(handle._closest, handle._context, pathWay);
+    return handle._status == SearchStatus::Found;
+}
+
+bool PathWorld::computePath(const Agent& agent, const Landmarks& landmarks, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const
+{
+    BT_PRE_CONDITION(pathWay.empty());                  // DEV Issue: Need an empty result!
+
+    const SearchResult result = searchPath(agent, landmarks, from, to, context);
+    if(result._found)
+    {
+        extractPath(to, context, pathWay);
+    }
+    return result._found;
+}
+
+void PathWorld::computePaths(const std::vector<PathQuery>& queries, std::vector<PathResult>& results, BT::ThreadPool& pool) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+    BT_PRE_CONDITION(queries.size() == results.size()); // DEV Issue: Need one result by query !
+
+    pool.parallelFor(queries.size(), [&](size_t queryID)
+    {
+        const PathQuery& query  = queries[queryID];
+        PathResult&      result = results[queryID];
+        BT_ASSERT(query._agent != nullptr);
+
+        PathSearchContext& context = PathSearchContext::getThreadContext();
+        const SearchResult search = searchPath(*query._agent, query._from, query._to, context, query._speedMode, query._mode);
+
+        result._pathWay.clear();
+        result._valid        = search._found;
+        result._nbExpansions = search._nbExpansions;
+        if(search._found)
+        {
+            extractPath(query._to, context, result._pathWay);
+        }
+    });
+}
+
+PathWorld::SearchResult PathWorld::computeCosts(const Agent& agent, const WalkTerrainID from, const std::vector<WalkTerrainID>& targets, std::vector<CostType>& costs, PathSearchContext& context, bool speedMode, std::vector<std::vector<BoostPoint>>* pathWays) const
+{
+    BT_PRE_CONDITION(from < _worldGraph.getNbNodes());  // DEV Issue: Invalid input !
+
+    costs.assign(targets.size(), std::numeric_limits<CostType>::infinity());
+    if(pathWays != nullptr)
+    {
+        pathWays->resize(targets.size());
+        for(auto& pathWay : *pathWays)
+        {
+            pathWay.clear();
+        }
+    }
+
+    // Keep only targets inside same sub-graph (else never solution so don't waste time)
+    std::vector<WalkTerrainID> reachable;
+    reachable.reserve(targets.size());
+    for(const WalkTerrainID to : targets)
+    {
+        if(isSameSubgraph(from, to))
+        {
+            reachable.push_back(to);
+        }
+    }
+    SearchResult result{ reachable.size() == targets.size(), 0, 0.0f };
+    if(reachable.empty())
+    {
+        return result;
+    }
+
+    // Same snapshot for whole search
+    const std::shared_ptr<const CostOverlay> overlay = getOverlay();
+    TargetsVisitor visitor(std::move(reachable));
+    const SearchResult search = searchWithWeight(agent, overlay.get(), speedMode, [&](auto weight)
+    {
+        return searchAStar(context, from, weight, [](WalkTerrainID) { return 0.0f; }, visitor);
+    });
+    result._found        = result._found && search._found;
+    result._nbExpansions = search._nbExpansions;
+
+    // Target behind blocked edges is never reached
+    for(size_t targetID = 0; targetID < targets.size(); ++targetID)
+    {
+        const CostType cost = context.getCost(targets[targetID]);
+        if(cost == std::numeric_limits<CostType>::infinity())
+        {
+            result._found = false;
+            continue;
+        }
+
+        costs[targetID] = cost;
+        result._cost    = std::max(result._cost, cost);
+        if(pathWays != nullptr)
+        {
+            extractPath(targets[targetID], context, (*pathWays)[targetID]);
+        }
+    }
+    return result;
+}
+
+PathWorld::SearchResult PathWorld::computeIsochrone(const Agent& agent, const WalkTerrainID from, const CostType budget, std::vector<ReachedNode>& reached, PathSearchContext& context, bool speedMode, BoostMultiPolygon* region) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+    BT_PRE_CONDITION(from < _worldGraph.getNbNodes());  // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(budget >= 0.0f);                   // DEV Issue: Invalid input !
+
+    reached.clear();
+
+    // Same snapshot for whole search
+    const std::shared_ptr<const CostOverlay> overlay = getOverlay();
+    BudgetVisitor visitor(context, budget, reached);
+    SearchResult result = searchWithWeight(agent, overlay.get(), speedMode, [&](auto weight)
+    {
+        return searchAStar(context, from, weight, [](WalkTerrainID) { return 0.0f; }, visitor);
+    });
+    result._cost = reached.back()._cost;
+
+    if(region != nullptr)
+    {
+        mergePolygons(reached, *region);
+    }
+    return result;
+}
+
+void PathWorld::mergePolygons(const std::vector<ReachedNode>& reached, BoostMultiPolygon& region) const
+{
+    // Floating overlay loses polygons sharing borders: merge on integer grid
+    using Point        = bg::model::point<BT::int64, 2, bg::cs::cartesian>;
+    using MultiPolygon = bg::model::multi_polygon<bg::model::polygon<Point, false, true>>;
+    const double gridSize = 100.0;     // 1 cm precision
+
+    std::vector<MultiPolygon> parts(reached.size());
+    for(size_t nodeID = 0; nodeID < reached.size(); ++nodeID)
+    {
+        parts[nodeID].resize(1);
+        auto& ring = parts[nodeID].front().outer();
+        for(const BoostPoint& point : _walkTerrains[reached[nodeID]._node]._polygon.outer())
+        {
+            ring.emplace_back(std::llround(point.get<0>() * gridSize), std::llround(point.get<1>() * gridSize));
+        }
+        ring.push_back(ring.front());
+    }
+
+    // Merge by pairs: each union stays small
+    while(parts.size() > 1)
+    {
+        const size_t nbMerged = (parts.size() + 1) / 2;
+        for(size_t partID = 0; partID < parts.size() / 2; ++partID)
+        {
+            MultiPolygon merged;
+            bg::union_(parts[2 * partID], parts[2 * partID + 1], merged);
+            parts[partID] = std::move(merged);
+        }
+        if(parts.size() % 2 == 1)
+        {
+            parts[nbMerged - 1] = std::move(parts.back());
+        }
+        parts.resize(nbMerged);
+    }
+
+    region.clear();
+    if(!parts.empty())
+    {
+        bg::convert(parts.front(), region);
+        bg::strategy::transform::scale_transformer<float, 2, 2> toWorld(1.0 / gridSize);
+        BoostMultiPolygon scaled;
+        bg::transform(region, scaled, toWorld);
+        region = std::move(scaled);
+    }
+}
+
+void PathWorld::computeCostMatrix(const Agent& agent, const std::vector<WalkTerrainID>& sources, const std::vector<WalkTerrainID>& targets, std::vector<CostType>& matrix, BT::ThreadPool& pool, bool speedMode) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+
+    const size_t nbTargets = targets.size();
+    matrix.assign(sources.size() * nbTargets, std::numeric_limits<CostType>::infinity());
+    pool.parallelFor(sources.size(), [&](size_t sourceID)
+    {
+        thread_local std::vector<CostType> costs;
+        computeCosts(agent, sources[sourceID], targets, costs, PathSearchContext::getThreadContext(), speedMode);
+        std::copy(costs.begin(), costs.end(), matrix.begin() + sourceID * nbTargets);
+    });
+}
+
+void PathWorld::computeCostMatrix(const ContractionHierarchy& hierarchy, const std::vector<WalkTerrainID>& sources, const std::vector<WalkTerrainID>& targets, std::vector<CostType>& matrix, BT::ThreadPool& pool) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+    BT_PRE_CONDITION(&hierarchy.getWorld() == this);    // DEV Issue: Hierarchy of another world !
+
+    hierarchy.computeCostMatrix(sources, targets, matrix, pool);
+}
+
+void PathWorld::extractPath(const WalkTerrainID to, const PathSearchContext& context, std::vector<BoostPoint>& pathWay) const
+{
+    BT_PRE_CONDITION(to < _worldGraph.getNbNodes());    // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(context.isReached(to));            // DEV Issue: Search failed or context reused !
+
+    for(WalkTerrainID v = to;; v = context.getPredecessor(v))
+    {
+        pathWay.emplace_back(_worldGraph.getCentroid(v));
+        if(context.getPredecessor(v) == v)
+            break;
+    }
+}
+
+namespace
+{
+    //------------------------------------------------------------------------
+    /// \brief  Twice signed area of triangle.
+    ///
+    /// \returns Positive if c is on left of a -> b, negative if on right.
+    float triangleArea2(const BoostPoint& a, const BoostPoint& b, const BoostPoint& c)
+    {
+        return (b.get<0>() - a.get<0>()) * (c.get<1>() - a.get<1>()) - (b.get<1>() - a.get<1>()) * (c.get<0>() - a.get<0>());
+    }
+
+    bool isSamePoint(const BoostPoint& a, const BoostPoint& b)
+    {
+        return a.get<0>() == b.get<0>() && a.get<1>() == b.get<1>();
+    }
+
+    //------------------------------------------------------------------------
+    /// \brief  Spread 16 bits on even bits (Morton code).
+    BT::uint32 spreadBits(BT::uint32 value)
+    {
+        value = (value | (value << 8)) & 0x00FF00FF;
+        value = (value | (value << 4)) & 0x0F0F0F0F;
+        value = (value | (value << 2)) & 0x33333333;
+        value = (value | (value << 1)) & 0x55555555;
+        return value;
+    }
+}
+
+const BT::uint32 PathWorld::_noNode;
+
+bool PathWorld::isInsidePolygon(const WalkTerrainID node, const BoostPoint& localization) const
+{
+    const float x = localization.get<0>();
+    const float y = localization.get<1>();
+
+    int crossings = 0;
+    for(BT::uint32 edge = _edges._offsets[node]; edge != _edges._offsets[node + 1]; ++edge)
+    {
+        const bool isAcross = (_edges._y0[edge] > y) != (_edges._y1[edge] > y);
+        const bool isRight  = x < _edges._x0[edge] + (y - _edges._y0[edge]) * _edges._slope[edge];
+        crossings += isAcross & isRight;
+    }
+    return (crossings & 1) != 0;
+}
+
+void PathWorld::locate(const std::vector<BoostPoint>& localizations, std::vector<WalkTerrainID>& nodes, BT::ThreadPool* pool) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+
+    nodes.assign(localizations.size(), _noNode);
+    if(localizations.empty())
+        return;
+
+    // Grid: one cell by point, no need to group
+    if(_indexType != IndexType::RTree)
+    {
+        const auto locateGrid = [&](size_t pointID)
+        {
+            const BoostPoint& point = localizations[pointID];
+            _grid.query(point, [&](WalkTerrainID candidate)
+            {
+                if(!isInsidePolygon(candidate, point))
+                    return false;
+                nodes[pointID] = candidate;
+                return true;
+            });
+        };
+        if(pool != nullptr && localizations.size() >= _parallelLocate)
+        {
+            pool->parallelFor(localizations.size(), locateGrid);
+        }
+        else
+        {
+            for(size_t pointID = 0; pointID < localizations.size(); ++pointID)
             {
-                // Compute agent weight
-                const auto weightMap = make_transform_value_property_map([&](EdgeInfo& e){ return updateWeight(agent, e); }, get(boost::edge_bundle, _worldGraph));
-                // call astar named parameter interface
-                boost::astar_search_tree(_worldGraph, from, TerrainHeuristic(goal, _worldGraph),
-                                    boost::predecessor_map(path.data()).visitor(GoalVisitor(to)).weight_map(weightMap)
-                );
+                locateGrid(pointID);
             }
+        }
+        return;
+    }
 
-            // NEVER Happens !!!
-            throw std::exception(u8"PathWorld_Corruption");
+    // Sort points along Morton curve of their bounding box: each group is compact
+    BoostBox bounds(localizations.front(), localizations.front());
+    for(const BoostPoint& point : localizations)
+    {
+        bg::expand(bounds, point);
+    }
+    const float width  = std::max(bounds.max_corner().get<0>() - bounds.min_corner().get<0>(), 1.0f);
+    const float height = std::max(bounds.max_corner().get<1>() - bounds.min_corner().get<1>(), 1.0f);
+    std::vector<std::pair<BT::uint32, BT::uint32>> order(localizations.size());
+    for(size_t pointID = 0; pointID < localizations.size(); ++pointID)
+    {
+        const BoostPoint& point = localizations[pointID];
+        const BT::uint32 cellX = static_cast<BT::uint32>((point.get<0>() - bounds.min_corner().get<0>()) / width  * 65535.0f);
+        const BT::uint32 cellY = static_cast<BT::uint32>((point.get<1>() - bounds.min_corner().get<1>()) / height * 65535.0f);
+        order[pointID] = std::make_pair(spreadBits(cellX) | (spreadBits(cellY) << 1), static_cast<BT::uint32>(pointID));
+    }
+    std::sort(order.begin(), order.end());
+
+    const size_t nbGroups = (order.size() + _locateGroup - 1) / _locateGroup;
+    const auto locateGroup = [&](size_t groupID)
+    {
+        const auto begin = order.begin() + groupID * _locateGroup;
+        const auto end   = order.begin() + std::min(order.size(), (groupID + 1) * _locateGroup);
+
+        // One query for whole group (buffer is kept by thread)
+        BoostBox box(localizations[begin->second], localizations[begin->second]);
+        for(auto it = begin; it != end; ++it)
+        {
+            bg::expand(box, localizations[it->second]);
         }
-        catch(GoalException&)
+        thread_local std::vector<AreaBox> candidates;
+        candidates.clear();
+        _quadTree.query(bgi::intersects(box), std::back_inserter(candidates));
+
+        for(auto it = begin; it != end; ++it)
         {
-            // Extract
-            pathWay.reserve(path.size());
-            for(WalkTerrainID v = to;; v = path[v])
+            const BoostPoint& point = localizations[it->second];
+            for(const AreaBox& candidate : candidates)
             {
-                pathWay.emplace_back(_worldGraph[v]._centroid);
-                if(path[v] == v)
+                if(bg::covered_by(point, candidate.first) && isInsidePolygon(candidate.second, point))
+                {
+                    nodes[it->second] = candidate.second;
                     break;
+                }
             }
-            valid = true;
         }
+    };
+
+    if(pool != nullptr && localizations.size() >= _parallelLocate)
+    {
+        pool->parallelFor(nbGroups, locateGroup);
     }
-    return valid;
+    else
+    {
+        for(size_t groupID = 0; groupID < nbGroups; ++groupID)
+        {
+            locateGroup(groupID);
+        }
+    }
+}
+
+bool PathWorld::relocateNearby(const WalkTerrainID previous, const BoostPoint& localization, WalkTerrainID& node, RelocateStats* stats) const
+{
+    BT_PRE_CONDITION(previous < _walkTerrains.size());  // DEV Issue: Invalid node !
+
+    if(isInsidePolygon(previous, localization))
+    {
+        node = previous;
+        if(stats != nullptr)
+            ++stats->_nbSame;
+        return true;
+    }
+
+    for(TerrainEdgeID edge = _worldGraph.beginEdge(previous); edge != _worldGraph.endEdge(previous); ++edge)
+    {
+        const WalkTerrainID neighbour = _worldGraph.getTarget(edge);
+        if(isInsidePolygon(neighbour, localization))
+        {
+            node = neighbour;
+            if(stats != nullptr)
+                ++stats->_nbNeighbour;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PathWorld::relocate(const WalkTerrainID previous, const BoostPoint& localization, WalkTerrainID& node, RelocateStats* stats) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+
+    if(previous != _noNode && relocateNearby(previous, localization, node, stats))
+        return true;
+
+    const bool isFound = locate(localization, node);
+    if(stats != nullptr)
+        ++(isFound ? stats->_nbIndex : stats->_nbOutside);
+    return isFound;
+}
+
+void PathWorld::relocate(const std::vector<BoostPoint>& localizations, std::vector<WalkTerrainID>& nodes, RelocateStats* stats) const
+{
+    BT_PRE_CONDITION(!isNull());                        // DEV Issue: No data into file !
+    BT_PRE_CONDITION(localizations.size() == nodes.size()); // DEV Issue: One previous node by point !
+
+    // Misses are scattered on map: grouped query of batch locate() would read too many boxes
+    for(size_t pointID = 0; pointID < localizations.size(); ++pointID)
+    {
+        WalkTerrainID node = _noNode;
+        relocate(nodes[pointID], localizations[pointID], node, stats);
+        nodes[pointID] = node;
+    }
+}
+
+void PathWorld::findPortal(const WalkTerrainID from, const WalkTerrainID to, BoostPoint& left, BoostPoint& right) const
+{
+    const auto& ring  = _walkTerrains[from]._polygon.outer();
+    const auto& other = _walkTerrains[to]._polygon.outer();
+    const auto isShared = [&](const BoostPoint& point)
+    {
+        return std::any_of(other.begin(), other.end(), [&](const BoostPoint& otherPoint) { return isSamePoint(point, otherPoint); });
+    };
+
+    // Counter clockwise ring: inside is on left of edge, so agent leaving goes from its right to its left
+    for(size_t pointID = 0; pointID < ring.size(); ++pointID)
+    {
+        const BoostPoint& current = ring[pointID];
+        const BoostPoint& next    = ring[(pointID + 1) % ring.size()];
+        if(isShared(current) && isShared(next))
+        {
+            right = current;
+            left  = next;
+            return;
+        }
+    }
+
+    // No common edge: go through centroid
+    left  = _worldGraph.getCentroid(to);
+    right = left;
+}
+
+void PathWorld::smoothPath(const WalkTerrainID to, const PathSearchContext& context, std::vector<BoostPoint>& pathWay) const
+{
+    BT_PRE_CONDITION(to < _worldGraph.getNbNodes());    // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(context.isReached(to));            // DEV Issue: Search failed or context reused !
+
+    // Funnel from goal to start: predecessors give portals in order
+    BoostPoint    apex      = _worldGraph.getCentroid(to);
+    BoostPoint    left      = apex;
+    BoostPoint    right     = apex;
+    WalkTerrainID leftNext  = to;
+    WalkTerrainID rightNext = to;
+    pathWay.push_back(apex);
+
+    // Portals touching apex give same corner again
+    const auto addCorner = [&](const BoostPoint& corner)
+    {
+        if(!isSamePoint(pathWay.back(), corner))
+        {
+            pathWay.push_back(corner);
+        }
+    };
+
+    WalkTerrainID node = to;
+    while(true)
+    {
+        const WalkTerrainID next   = context.getPredecessor(node);
+        const bool          isLast = next == node;
+        BoostPoint portalLeft;
+        BoostPoint portalRight;
+        if(isLast)
+        {
+            portalLeft  = _worldGraph.getCentroid(node);
+            portalRight = portalLeft;
+        }
+        else
+        {
+            findPortal(node, next, portalLeft, portalRight);
+        }
+
+        // Tighten right side (or left side becomes corner when crossed)
+        if(triangleArea2(apex, right, portalRight) >= 0.0f)
+        {
+            if(isSamePoint(apex, right) || triangleArea2(apex, left, portalRight) < 0.0f)
+            {
+                right     = portalRight;
+                rightNext = next;
+            }
+            else
+            {
+                apex  = left;
+                right = left;
+                addCorner(apex);
+                node      = leftNext;
+                rightNext = leftNext;
+                continue;
+            }
+        }
+
+        // Tighten left side (or right side becomes corner when crossed)
+        if(triangleArea2(apex, left, portalLeft) <= 0.0f)
+        {
+            if(isSamePoint(apex, left) || triangleArea2(apex, right, portalLeft) > 0.0f)
+            {
+                left     = portalLeft;
+                leftNext = next;
+            }
+            else
+            {
+                apex = right;
+                left = right;
+                addCorner(apex);
+                node     = rightNext;
+                leftNext = rightNext;
+                continue;
+            }
+        }
+
+        if(isLast)
+            break;
+        node = next;
+    }
+
+    addCorner(_worldGraph.getCentroid(node));
 }
 
 const PathWorld::WalkTerrain& PathWorld::getWalkTerrain(const AreaBox& area) const
 {
     BT_PRE_CONDITION(!isNull());                                // DEV Issue: No data into file !
-    BT_PRE_CONDITION(num_vertices(_worldGraph) > 0);            // DEV Issue: Valid file !
+    BT_PRE_CONDITION(_worldGraph.getNbNodes() > 0);             // DEV Issue: Valid file !
 
-    BT_PRE_CONDITION(area.second < num_vertices(_worldGraph));  // DEV Issue: Check in range !
+    BT_PRE_CONDITION(area.second < _walkTerrains.size());       // DEV Issue: Check in range !
 
-    return _worldGraph[area.second];
+    return _walkTerrains[area.second];
 }
 
 const PathWorld::WalkTerrain& PathWorld::getWalkTerrain(const WalkTerrainID& id) const
 {
     BT_PRE_CONDITION(!isNull());                         // DEV Issue: No data into file !
-    BT_PRE_CONDITION(num_vertices(_worldGraph) > 0);   // DEV Issue: Valid file !
-    BT_PRE_CONDITION(id < num_vertices(_worldGraph));  // DEV Issue: Check in range !
+    BT_PRE_CONDITION(_worldGraph.getNbNodes() > 0);    // DEV Issue: Valid file !
+    BT_PRE_CONDITION(id < _walkTerrains.size());       // DEV Issue: Check in range !
 
-    return _worldGraph[id];
+    return _walkTerrains[id];
 }
 
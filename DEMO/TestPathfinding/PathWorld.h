@@ -1,19 +1,21 @@
 #pragma once
 
 #include "Define.h"
+#include "CostOverlay.h"
+#include "GridIndex.h"
+#include "PathCache.h"
+#include "PathSearchContext.h"
+#include "TerrainGraph.h"
 
-/// Terrain type
-enum Type
+namespace BT
 {
-    Ocean,
-    Swamp,
-    Forest,
-    Clay,
-    Linestone,
-    Sand,
-    Rock,
-    NbType
-};
+    class File;
+    class ThreadPool;
+}
+class ClusterGraph;
+class ContractionHierarchy;
+class Landmarks;
+class WeightProfile;
 
 class Agent
 {
@@ -75,10 +77,13 @@ class PathWorld final
     public:
         static const BT::int32  _version    = 010001; ///< File version XX Major XXXX Minor
 
-        struct EdgeInfo;
+        static const BT::uint32 _noNode         = std::numeric_limits<BT::uint32>::max();  ///< Point outside all polygons.
+        static const size_t     _locateGroup    = 32;       ///< Nearby points sharing one tree query.
+        static const size_t     _parallelLocate = 4096;     ///< Minimum number of points to use workers.
 
         //----------------------------------------------------------------------------
         /// \brief Subdivision of Terrain to navigate properly.
+        /// \note Search reads copy of hot fields stored into TerrainGraph.
         struct WalkTerrain
         {
             Terrain         _terrain;       ///< Terrain info.
@@ -96,24 +101,9 @@ class PathWorld final
             {}
         };
 
-        using TerrainGraph      = boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS,
-            WalkTerrain,
-            EdgeInfo>;   ///< Graph
-
-        using WalkTerrainID     = boost::graph_traits<TerrainGraph>::vertex_descriptor;
-        using TerrainEdgeID     = boost::graph_traits<TerrainGraph>::edge_descriptor;
-
-        struct EdgeInfo
-        {
-            // Constructor: invalid by default
-            EdgeInfo(const float distance = -1.0f, const WalkTerrain* from=nullptr, const WalkTerrain* to=nullptr) :
-                _from(from), _to(to), _distance(distance)
-            {}
-
-            const WalkTerrain* _from;   ///< [LINK] Link to WorldGraph node. WARNING: No destruction.
-            const WalkTerrain* _to;     ///< [LINK] Link to WorldGraph node. WARNING: No destruction.
-            float        _distance;     ///< Distance between from/to centroid.
-        };
+        using WalkTerrainID     = TerrainGraph::NodeID;
+        using TerrainEdgeID     = TerrainGraph::EdgeID;
+        static_assert(std::is_same<WalkTerrainID, PathSearchContext::NodeID>::value, "Context must use same node ID");
 
         using AreaBox           = std::pair<BoostBox, WalkTerrainID>;
 
@@ -121,51 +111,270 @@ class PathWorld final
         using CostType          = float;
 
         // euclidean distance heuristic
-        class TerrainHeuristic : public boost::astar_heuristic<TerrainGraph, CostType>
+        class TerrainHeuristic
         {
             public:
-            TerrainHeuristic(const WalkTerrain& goal, const TerrainGraph& worldGraph) :
+            TerrainHeuristic(const BoostPoint& goal, const TerrainGraph& worldGraph) :
                 _goal(goal), _worldGraph(worldGraph)
             {}
 
-            CostType operator()(WalkTerrainID current)
+            CostType operator()(WalkTerrainID current) const
             {
-                const WalkTerrain& node = _worldGraph[current];
+                const BoostPoint& centroid = _worldGraph.getCentroid(current);
                 BoostPoint distance;
-                distance.set<0>(_goal._centroid.get<0>() - node._centroid.get<0>());
-                distance.set<1>(_goal._centroid.get<1>() - node._centroid.get<1>());
+                distance.set<0>(_goal.get<0>() - centroid.get<0>());
+                distance.set<1>(_goal.get<1>() - centroid.get<1>());
                 // Compute dot = length * length
                 return bg::dot_product(distance, distance);
             }
 
             private:
-            const WalkTerrain&  _goal;
+            const BoostPoint&   _goal;
             const TerrainGraph& _worldGraph;
         };
 
-        struct GoalException{}; // exception for termination
+        /// Answer of visitor when a node is examined.
+        enum class VisitorStatus
+        {
+            Continue,   ///< Search goes on.
+            Stop        ///< Goal reached: search ends.
+        };
+
+        /// Structure used to find node under point (see locate()).
+        enum class IndexType
+        {
+            RTree,          ///< R*-tree of polygon boxes.
+            UniformGrid,    ///< One grid: one cell read by query.
+            MultiLevelGrid  ///< Grids of growing cell size: one cell read by level.
+        };
+
+        /// Direction of search.
+        enum class SearchMode
+        {
+            Forward,        ///< A* from start to goal (fast heuristic, path may be not optimal).
+            Bidirectional   ///< A* from both sides with admissible heuristic (optimal path).
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief Summary of one search.
+        struct SearchResult
+        {
+            bool        _found;         ///< Goal was reached.
+            BT::uint32  _nbExpansions;  ///< Number of examined nodes.
+            CostType    _cost;          ///< Cost of path (only if found).
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief Node reached by isochrone.
+        struct ReachedNode
+        {
+            WalkTerrainID   _node;      ///< Reached node.
+            CostType        _cost;      ///< Arrival cost from start.
+        };
 
-        // visitor that terminates when we find the goal
-        class GoalVisitor : public boost::default_astar_visitor
+        //----------------------------------------------------------------------------
+        /// \brief Counters of relocate(): where moving points were found.
+        struct RelocateStats
+        {
+            size_t  _nbSame      = 0;   ///< Still inside previous node.
+            size_t  _nbNeighbour = 0;   ///< Moved to neighbour of previous node.
+            size_t  _nbIndex     = 0;   ///< Found by spatial index (miss).
+            size_t  _nbOutside   = 0;   ///< Outside world.
+
+            size_t getNbQueries() const
+            {
+                return _nbSame + _nbNeighbour + _nbIndex + _nbOutside;
+            }
+
+            //------------------------------------------------------------------------
+            /// \brief  Get part of queries solved without spatial index.
+            /// 
+            /// \returns Ratio between 0 and 1 (0 without query).
+            float getHitRate() const
+            {
+                const size_t nbQueries = getNbQueries();
+                return nbQueries == 0 ? 0.0f : static_cast<float>(_nbSame + _nbNeighbour) / static_cast<float>(nbQueries);
+            }
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief Input of batch computation.
+        struct PathQuery
+        {
+            const Agent*    _agent;         ///< [LINK] Who moves. WARNING: No destruction.
+            WalkTerrainID   _from;          ///< Start node.
+            WalkTerrainID   _to;            ///< Goal node.
+            bool            _speedMode;     ///< Use only distance as weight.
+            SearchMode      _mode;          ///< Direction of search.
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief Output of batch computation.
+        struct PathResult
+        {
+            std::vector<BoostPoint> _pathWay;       ///< Centroid of each node from goal to start.
+            bool                    _valid;         ///< Path exists.
+            BT::uint32              _nbExpansions;  ///< Number of examined nodes.
+
+            /// Constructor
+            PathResult():
+            _valid(false), _nbExpansions(0)
+            {}
+        };
+
+        // visitor that stops search when we find the goal
+        class GoalVisitor
         {
             public:
             GoalVisitor(WalkTerrainID goal) :
                 _goal(goal)
             {}
 
-            template <class Graph>
-            void examine_vertex(WalkTerrainID u, Graph& /*g*/)
+            VisitorStatus examineVertex(WalkTerrainID u) const
             {
-                if(u == _goal)
-                    throw GoalException();
+                return u == _goal ? VisitorStatus::Stop : VisitorStatus::Continue;
             }
 
             private:
             WalkTerrainID _goal;
         };
 
+        // visitor that stops search when all targets are examined
+        class TargetsVisitor
+        {
+            public:
+            TargetsVisitor(std::vector<WalkTerrainID>&& targets) :
+                _targets(std::move(targets))
+            {
+                std::sort(_targets.begin(), _targets.end());
+                _targets.erase(std::unique(_targets.begin(), _targets.end()), _targets.end());
+            }
+
+            VisitorStatus examineVertex(WalkTerrainID u)
+            {
+                const auto it = std::lower_bound(_targets.begin(), _targets.end(), u);
+                if(it != _targets.end() && *it == u)
+                {
+                    _targets.erase(it);
+                }
+                return _targets.empty() ? VisitorStatus::Stop : VisitorStatus::Continue;
+            }
+
+            private:
+            std::vector<WalkTerrainID> _targets;    ///< Sorted targets not examined yet.
+        };
+
+        // visitor that keeps examined nodes and stops search above budget
+        class BudgetVisitor
+        {
+            public:
+            BudgetVisitor(const PathSearchContext& context, CostType budget, std::vector<ReachedNode>& reached) :
+                _context(context), _budget(budget), _reached(reached)
+            {}
+
+            VisitorStatus examineVertex(WalkTerrainID u)
+            {
+                const CostType cost = _context.getCost(u);
+                if(cost > _budget)
+                    return VisitorStatus::Stop;
+                _reached.push_back({ u, cost });
+                return VisitorStatus::Continue;
+            }
+
+            private:
+            const PathSearchContext&    _context;
+            CostType                    _budget;
+            std::vector<ReachedNode>&   _reached;
+        };
+
+        // visitor that stops on goal and keeps examined node nearest to goal (partial path)
+        class ClosestVisitor
+        {
+            public:
+            ClosestVisitor(WalkTerrainID goal, const TerrainHeuristic& heuristic, WalkTerrainID& closest, CostType& closestEstimation) :
+                _goal(goal), _heuristic(heuristic), _closest(closest), _closestEstimation(closestEstimation)
+            {}
+
+            VisitorStatus examineVertex(WalkTerrainID u)
+            {
+                const CostType estimation = _heuristic(u);
+                if(estimation < _closestEstimation)
+                {
+                    _closest           = u;
+                    _closestEstimation = estimation;
+                }
+                return u == _goal ? VisitorStatus::Stop : VisitorStatus::Continue;
+            }
+
+            private:
+            WalkTerrainID           _goal;
+            const TerrainHeuristic& _heuristic;
+            WalkTerrainID&          _closest;
+            CostType&               _closestEstimation;
+        };
+
+        /// Progress of time-sliced search.
+        enum class SearchStatus
+        {
+            Idle,       ///< No search started (see beginPath()).
+            Running,    ///< Open list not empty: call step() again.
+            Found,      ///< Goal reached.
+            NotFound    ///< No path between nodes.
+        };
+
+        //----------------------------------------------------------------------------
+        /// \brief State of time-sliced A* (see beginPath()): whole search lives here so
+        /// one query can be spread over several ticks.
+        /// \note Agent must stay alive until search ends.
+        class SearchHandle final
+        {
+            BT_NOCOPY(SearchHandle);
+
+            public:
+                /// Constructor
+                SearchHandle():
+                _agent(nullptr), _from(0), _to(0), _speedMode(false), _status(SearchStatus::Idle),
+                _result{ false, 0, 0.0f }, _closest(0), _closestEstimation(0.0f)
+                {}
+
+                SearchHandle(SearchHandle&&) = default;
+                SearchHandle& operator=(SearchHandle&&) = default;
+
+                /// Destructor
+                ~SearchHandle() = default;
+
+                SearchStatus getStatus() const
+                {
+                    return _status;
+                }
+
+                //------------------------------------------------------------------------
+                /// \brief  Get summary of search (cost only when found).
+                ///
+                /// \returns Found flag, number of examined nodes since beginPath() and cost.
+                const SearchResult& getResult() const
+                {
+                    return _result;
+                }
+
+            private:
+                friend class PathWorld;
+
+                PathSearchContext                   _context;       ///< Workspace of this search only.
+                const Agent*                        _agent;         ///< [LINK] Who moves.
+                std::shared_ptr<const CostOverlay>  _overlay;       ///< [OWNERSHIP] Snapshot at beginPath(): same weights on all ticks.
+                WalkTerrainID                       _from;          ///< Start node.
+                WalkTerrainID                       _to;            ///< Goal node.
+                bool                                _speedMode;     ///< Use only distance as weight.
+                SearchStatus                        _status;        ///< Progress.
+                SearchResult                        _result;        ///< Summary of all steps.
+                WalkTerrainID                       _closest;       ///< Examined node nearest to goal (partial path).
+                CostType                            _closestEstimation; ///< Heuristic of _closest.
+        };
+
         /// Constructor
-        PathWorld()
+        PathWorld():
+        _indexType(IndexType::RTree)
         {
             BT_PRE_CONDITION(isNull());
         }
@@ -176,7 +385,26 @@ class PathWorld final
             BT_POST_CONDITION(isNull());
         }
 
-        void initialize(BT::File& file);
+        //------------------------------------------------------------------------
+        /// \brief  Read world then build graph and spatial indexes.
+        /// 
+        /// \param[in,out] file: opened map file.
+        /// \param[in] index: structure used by locate() (R*-tree is always built for region queries).
+        void initialize(BT::File& file, IndexType index = IndexType::RTree);
+
+        IndexType getIndexType() const
+        {
+            return _indexType;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get grid used by locate() (null with R*-tree).
+        /// 
+        /// \returns Grid index.
+        const GridIndex& getGridIndex() const
+        {
+            return _grid;
+        }
 
         //------------------------------------------------------------------------
         /// \brief  Check if QuadTree is null.
@@ -196,6 +424,42 @@ class PathWorld final
         /// \returns List of nearest elements 
         AreaBox findNearest(const BoostPoint& localization) const;
 
+        //------------------------------------------------------------------------
+        /// \brief  Find node whose polygon contains point (no allocation, no exception).
+        /// 
+        /// \param[in] localization: point in world coordinate.
+        /// \param[out] node: node under point (only if found).
+        /// \returns True if point is inside one polygon, false otherwise.
+        bool locate(const BoostPoint& localization, WalkTerrainID& node) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Find node of many points: nearby points (Morton order) share one tree query
+        /// then crossing test reads flattened edges of candidates.
+        /// 
+        /// \param[in] localizations: points in world coordinate.
+        /// \param[out] nodes: node under each point (_noNode if outside world).
+        /// \param[in,out] pool: if not null, workers used for large batches.
+        void locate(const std::vector<BoostPoint>& localizations, std::vector<WalkTerrainID>& nodes, BT::ThreadPool* pool = nullptr) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Find node of moving point: check previous node then its neighbours,
+        /// spatial index is only used on miss.
+        /// 
+        /// \param[in] previous: node of point at last update (_noNode if unknown).
+        /// \param[in] localization: new point in world coordinate.
+        /// \param[out] node: node under point (only if found).
+        /// \param[in,out] stats: if not null, counters are increased.
+        /// \returns True if point is inside one polygon, false otherwise.
+        bool relocate(const WalkTerrainID previous, const BoostPoint& localization, WalkTerrainID& node, RelocateStats* stats = nullptr) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Find node of many moving points (agents array updated in place).
+        /// 
+        /// \param[in] localizations: new points in world coordinate.
+        /// \param[in,out] nodes: node of each point at last update (_noNode if unknown), then new node (_noNode if outside world).
+        /// \param[in,out] stats: if not null, counters are increased.
+        void relocate(const std::vector<BoostPoint>& localizations, std::vector<WalkTerrainID>& nodes, RelocateStats* stats = nullptr) const;
+
         //------------------------------------------------------------------------
         /// \brief  Get associated data from Area to WalkTerrain
         /// 
@@ -206,14 +470,460 @@ class PathWorld final
 
         bool computePath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, bool speedMode = false);
 
-        float updateWeight(const Agent& agent, const EdgeInfo& edgeInfo) const;
-        float updateSpeedWeight(const EdgeInfo& edgeInfo) const;
+        //------------------------------------------------------------------------
+        /// \brief  Compute path using caller workspace (no allocation once context is warm).
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] pathWay: centroid of each node from goal to start.
+        /// \param[in,out] context: workspace of current thread.
+        /// \param[in] speedMode: use only distance as weight.
+        /// \param[in] mode: direction of search.
+        /// \returns True if path exists, false otherwise.
+        bool computePath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, bool speedMode = false, SearchMode mode = SearchMode::Forward) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute path reading precomputed weight of each edge (see WeightProfile::build()).
+        /// 
+        /// \param[in] profile: weights of this world for one agent profile (and its speed mode).
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] pathWay: centroid of each node from goal to start.
+        /// \param[in,out] context: workspace of current thread.
+        /// \param[in] mode: direction of search.
+        /// \returns True if path exists, false otherwise.
+        bool computePath(const WeightProfile& profile, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, SearchMode mode = SearchMode::Forward) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Same as computePath() but read/store route into path cache (see getPathCache()).
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] pathWay: centroid of each node from goal to start.
+        /// \param[in,out] context: workspace of current thread (used only on miss).
+        /// \param[in] speedMode: use only distance as weight.
+        /// \param[in] mode: direction of search.
+        /// \returns True if path exists, false otherwise.
+        bool computeCachedPath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, bool speedMode = false, SearchMode mode = SearchMode::Forward) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Get cache of routes shared by all threads (cleared by release()).
+        /// 
+        /// \returns Cache (capacity and hit/miss counters).
+        PathCache& getPathCache() const
+        {
+            return _pathCache;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute path between two points of world (see locate()).
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] from: start point.
+        /// \param[in] to: goal point.
+        /// \param[out] pathWay: to, centroid of each node between, then from.
+        /// \param[in,out] context: workspace of current thread.
+        /// \param[in] speedMode: use only distance as weight.
+        /// \param[in] mode: direction of search.
+        /// \returns True if path exists, false otherwise (point outside world or other sub-graph).
+        bool computePath(const Agent& agent, const BoostPoint& from, const BoostPoint& to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, bool speedMode = false, SearchMode mode = SearchMode::Forward) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Same as computePath() then string pulling through shared edges of polygons (see smoothPath()).
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] pathWay: corners from goal centroid to start centroid.
+        /// \param[in,out] context: workspace of current thread.
+        /// \param[in] speedMode: use only distance as weight.
+        /// \param[in] mode: direction of search.
+        /// \returns True if path exists, false otherwise.
+        bool computeSmoothPath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context, bool speedMode = false, SearchMode mode = SearchMode::Forward) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute path with bidirectional query on contraction hierarchy (see ContractionHierarchy::build()).
+        /// 
+        /// \param[in] hierarchy: preprocessing of this world for one agent profile.
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] pathWay: centroid of each node from goal to start (shortcuts are unpacked).
+        /// \param[in,out] context: workspace of current thread.
+        /// \returns True if path exists, false otherwise.
+        bool computePath(const ContractionHierarchy& hierarchy, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute path on abstract graph of clusters then refine inside its corridor (see ClusterGraph::build()).
+        /// 
+        /// \param[in] clusters: two-level hierarchy of this world for one agent profile.
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] pathWay: centroid of each node from goal to start.
+        /// \param[in,out] context: workspace of current thread.
+        /// \returns True if path exists, false otherwise.
+        bool computePath(const ClusterGraph& clusters, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute optimal path with A* guided by landmarks (ALT heuristic).
+        /// 
+        /// \param[in] agent: who moves (same profile as landmarks).
+        /// \param[in] landmarks: landmarks of this world for agent profile (and its speed mode).
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] pathWay: centroid of each node from goal to start.
+        /// \param[in,out] context: workspace of current thread.
+        /// \returns True if path exists, false otherwise.
+        bool computePath(const Agent& agent, const Landmarks& landmarks, const WalkTerrainID from, const WalkTerrainID to, std::vector<BoostPoint>& pathWay, PathSearchContext& context) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Run search only: path stays into context (see extractPath()).
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[in,out] context: workspace of current thread.
+        /// \param[in] speedMode: use only distance as weight.
+        /// \param[in] mode: direction of search.
+        /// \returns Goal found and number of examined nodes.
+        SearchResult searchPath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context, bool speedMode = false, SearchMode mode = SearchMode::Forward) const;
+        SearchResult searchPath(const Agent& agent, const Landmarks& landmarks, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context) const;
+        SearchResult searchPath(const WeightProfile& profile, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context, SearchMode mode = SearchMode::Forward) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Start time-sliced A* (nothing is examined before step()).
+        /// 
+        /// \param[in] agent: who moves (speed by terrain), linked until search ends.
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[out] handle: state of search (previous search is dropped).
+        /// \param[in] speedMode: use only distance as weight.
+        void beginPath(const Agent& agent, const WalkTerrainID from, const WalkTerrainID to, SearchHandle& handle, bool speedMode = false) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Go on with time-sliced A*.
+        /// 
+        /// \param[in,out] handle: state of search (see beginPath()).
+        /// \param[in] maxExpansions: budget of examined nodes for this tick.
+        /// \returns Status after this step.
+        SearchStatus step(SearchHandle& handle, const BT::uint32 maxExpansions) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Read path of time-sliced A*: full path when found, else best-so-far path
+        /// to examined node nearest to goal.
+        /// 
+        /// \param[in] handle: state of search (see beginPath()).
+        /// \param[out] pathWay: centroid of each node from goal (or nearest node) to start.
+        /// \returns True if path reaches goal, false if partial.
+        bool result(const SearchHandle& handle, std::vector<BoostPoint>& pathWay) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute many paths in parallel: each worker reads same world without lock.
+        /// 
+        /// \param[in] queries: all paths to compute.
+        /// \param[out] results: result of each query (same size as queries).
+        /// \param[in,out] pool: workers (each one uses its own PathSearchContext).
+        void computePaths(const std::vector<PathQuery>& queries, std::vector<PathResult>& results, BT::ThreadPool& pool) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute cost from one start to many targets with one Dijkstra sweep
+        /// (stops when all reachable targets are examined).
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] from: start node.
+        /// \param[in] targets: goal nodes (other sub-graph is rejected without search).
+        /// \param[out] costs: cost of each target (infinity if not reachable).
+        /// \param[in,out] context: workspace of current thread.
+        /// \param[in] speedMode: use only distance as weight.
+        /// \param[out] pathWays: if not null, centroid of each node from target to start (empty if not reachable).
+        /// \returns All targets found, number of examined nodes and highest cost of reached targets.
+        SearchResult computeCosts(const Agent& agent, const WalkTerrainID from, const std::vector<WalkTerrainID>& targets, std::vector<CostType>& costs, PathSearchContext& context, bool speedMode = false, std::vector<std::vector<BoostPoint>>* pathWays = nullptr) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute all nodes reachable within budget (Dijkstra stopped at budget).
+        /// No allocation once context and reached are warm: keep them for next query.
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] from: start node.
+        /// \param[in] budget: maximum arrival cost (hours, or distance in speed mode).
+        /// \param[out] reached: reached nodes sorted by arrival cost (start first).
+        /// \param[in,out] context: workspace of current thread.
+        /// \param[in] speedMode: use only distance as weight.
+        /// \param[out] region: if not null, union of polygons of reached nodes.
+        /// \returns Stopped by budget (false if whole sub-graph is reached), number of examined nodes and highest arrival cost.
+        SearchResult computeIsochrone(const Agent& agent, const WalkTerrainID from, const CostType budget, std::vector<ReachedNode>& reached, PathSearchContext& context, bool speedMode = false, BoostMultiPolygon* region = nullptr) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute cost between each source and each target: one row (one-to-many sweep) by worker.
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] sources: start nodes (one row each).
+        /// \param[in] targets: goal nodes (one column each).
+        /// \param[out] matrix: dense row-major costs (matrix[source * targets.size() + target], infinity if not reachable).
+        /// \param[in,out] pool: workers (each one uses its own PathSearchContext).
+        /// \param[in] speedMode: use only distance as weight.
+        void computeCostMatrix(const Agent& agent, const std::vector<WalkTerrainID>& sources, const std::vector<WalkTerrainID>& targets, std::vector<CostType>& matrix, BT::ThreadPool& pool, bool speedMode = false) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute cost between each source and each target with buckets on contraction hierarchy (see ContractionHierarchy::computeCostMatrix()).
+        /// 
+        /// \param[in] hierarchy: preprocessing of this world for one agent profile.
+        /// \param[in] sources: start nodes (one row each).
+        /// \param[in] targets: goal nodes (one column each).
+        /// \param[out] matrix: dense row-major costs (matrix[source * targets.size() + target], infinity if not reachable).
+        /// \param[in,out] pool: workers (each one uses its own PathSearchContext).
+        void computeCostMatrix(const ContractionHierarchy& hierarchy, const std::vector<WalkTerrainID>& sources, const std::vector<WalkTerrainID>& targets, std::vector<CostType>& matrix, BT::ThreadPool& pool) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Read path found by last search of context.
+        /// 
+        /// \param[in] to: goal node of search.
+        /// \param[in] context: workspace where goal was reached.
+        /// \param[out] pathWay: centroid of each node from goal to start.
+        void extractPath(const WalkTerrainID to, const PathSearchContext& context, std::vector<BoostPoint>& pathWay) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Read path found by last search of context and keep only its corners (simple stupid funnel).
+        /// Portals are shared edges of consecutive polygons (centroid of next node if none).
+        /// Only corners are appended: no allocation if pathWay has enough capacity.
+        /// 
+        /// \param[in] to: goal node of search.
+        /// \param[in] context: workspace where goal was reached.
+        /// \param[out] pathWay: corners from goal centroid to start centroid.
+        void smoothPath(const WalkTerrainID to, const PathSearchContext& context, std::vector<BoostPoint>& pathWay) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Get time (in hour) for agent to walk along edge.
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] from: source node of edge.
+        /// \param[in] edge: out edge of from.
+        /// \returns Weight of edge.
+        float updateWeight(const Agent& agent, const WalkTerrainID from, const TerrainEdgeID edge) const;
+        float updateSpeedWeight(const TerrainEdgeID edge) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Get weight with runtime changes (see blockEdges()).
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] from: source node of edge.
+        /// \param[in] edge: out edge of from.
+        /// \param[in] overlay: snapshot of changes.
+        /// \returns Weight of edge (infinity if blocked).
+        float updateWeight(const Agent& agent, const WalkTerrainID from, const TerrainEdgeID edge, const CostOverlay& overlay) const;
+        float updateSpeedWeight(const TerrainEdgeID edge, const CostOverlay& overlay) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Block edges (one direction: add reverse edge to block both). One new overlay version.
+        /// 
+        /// \param[in] edges: edges of graph.
+        void blockEdges(const std::vector<TerrainEdgeID>& edges);
+
+        //------------------------------------------------------------------------
+        /// \brief  Remove multiplier and block flag of edges. One new overlay version.
+        /// 
+        /// \param[in] edges: edges of graph.
+        void resetEdges(const std::vector<TerrainEdgeID>& edges);
+
+        //------------------------------------------------------------------------
+        /// \brief  Replace terrain of nodes (NbType = back to map terrain). One new overlay version.
+        /// 
+        /// \param[in] terrains: node and its new terrain (never change Ocean to land or land to Ocean).
+        void setTerrainOverride(const std::vector<std::pair<WalkTerrainID, Type>>& terrains);
+
+        //------------------------------------------------------------------------
+        /// \brief  Multiply weight of all edges of nodes touching region (both directions). One new overlay version.
+        /// 
+        /// \param[in] region: area in world coordinate.
+        /// \param[in] factor: positive multiplier (infinity = blocked).
+        void scaleRegion(const BoostBox& region, const float factor);
+
+        //------------------------------------------------------------------------
+        /// \brief  Remove all runtime changes (new version).
+        /// 
+        void clearOverrides();
+
+        //------------------------------------------------------------------------
+        /// \brief  Get current snapshot of runtime changes (never modified, keep it for whole search).
+        /// 
+        /// \returns Snapshot or null if no change since initialize().
+        std::shared_ptr<const CostOverlay> getOverlay() const
+        {
+            return std::atomic_load(&_overlay);
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get version of current snapshot (structures built with older one must be rebuilt).
+        /// 
+        /// \returns Version (0 if no change since initialize()).
+        CostOverlay::Version getOverlayVersion() const
+        {
+            const std::shared_ptr<const CostOverlay> overlay = getOverlay();
+            return overlay ? overlay->getVersion() : 0;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get lowest weight by unit of straight distance between centroids.
+        /// Slope factor is 0.5 at least and mean speed is lower than fastest terrain.
+        /// 
+        /// \param[in] navigation: agent profile (speed by terrain).
+        /// \param[in] speedMode: use only distance as weight.
+        /// \returns Factor so that factor * straight distance never overestimates cost.
+        CostType getMinCostByDistance(const Agent::Navigation& navigation, bool speedMode) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Get compact graph used by search.
+        /// 
+        /// \returns Graph.
+        const TerrainGraph& getGraph() const
+        {
+            return _worldGraph;
+        }
 
     private:
         void loadGraph(BT::File& file);
 
+        //------------------------------------------------------------------------
+        /// \brief  A* loop on graph using context storage (tree search: node can be reopened).
+        /// 
+        /// \param[in,out] context: workspace where predecessor/cost are written.
+        /// \param[in] from: start node.
+        /// \param[in] weight: functor to get cost of edge (source node, edge).
+        /// \param[in] heuristic: functor to estimate cost from node to goal.
+        /// \param[in,out] visitor: called on each examined node, stops search when it returns VisitorStatus::Stop.
+        /// \returns Stopped by visitor and number of examined nodes.
+        template<typename WeightFunctor, typename Heuristic, typename Visitor>
+        SearchResult searchAStar(PathSearchContext& context, const WalkTerrainID from, WeightFunctor weight, Heuristic heuristic, Visitor& visitor) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Resume A* loop on open list of context (see searchAStar()).
+        /// 
+        /// \param[in,out] context: workspace with open list of started search.
+        /// \param[in] weight: functor to get cost of edge (source node, edge).
+        /// \param[in] heuristic: functor to estimate cost from node to goal.
+        /// \param[in,out] visitor: called on each examined node, stops search when it returns VisitorStatus::Stop.
+        /// \param[in] maxExpansions: budget of examined nodes.
+        /// \param[in,out] result: stopped by visitor, number of examined nodes is increased.
+        template<typename WeightFunctor, typename Heuristic, typename Visitor>
+        void stepAStar(PathSearchContext& context, WeightFunctor weight, Heuristic heuristic, Visitor& visitor, const BT::uint32 maxExpansions, SearchResult& result) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  A* from both sides with balanced potentials (forward: (h_goal - h_start) / 2).
+        /// Stops when both open lists can't improve best meeting, then writes whole path into context.
+        /// 
+        /// \param[in,out] context: workspace of forward side (reverse side holds backward search).
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[in] weight: functor to get cost of edge (source node, edge).
+        /// \param[in] costByDistance: factor so that factor * straight distance never overestimates cost.
+        /// \returns Goal found, number of examined nodes (both sides) and cost of path.
+        template<typename WeightFunctor>
+        SearchResult searchBidirectional(PathSearchContext& context, const WalkTerrainID from, const WalkTerrainID to, WeightFunctor weight, const CostType costByDistance) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Check query nodes and their connectivity.
+        /// 
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \returns True if both nodes are inside same sub-graph (else never solution).
+        bool isSameSubgraph(const WalkTerrainID from, const WalkTerrainID to) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Call search with weight functor of agent (with overlay if any).
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] overlay: snapshot of runtime changes (null if none).
+        /// \param[in] speedMode: use only distance as weight.
+        /// \param[in] search: generic functor called with weight functor (source node, edge).
+        /// \returns Result of search.
+        template<typename Search>
+        SearchResult searchWithWeight(const Agent& agent, const CostOverlay* overlay, bool speedMode, Search search) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Same as searchPath() with snapshot already read.
+        /// 
+        /// \param[in] overlay: snapshot of runtime changes (null if none).
+        SearchResult searchWithOverlay(const Agent& agent, const CostOverlay* overlay, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context, bool speedMode, SearchMode mode) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Crossing number test on flattened edges (branch-free loop for vectorization).
+        /// 
+        /// \param[in] node: polygon to test.
+        /// \param[in] localization: point in world coordinate.
+        /// \returns True if point is inside polygon.
+        bool isInsidePolygon(const WalkTerrainID node, const BoostPoint& localization) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Search point in previous node then in its neighbours.
+        /// 
+        /// \param[in] previous: node of point at last update.
+        /// \param[in] localization: new point in world coordinate.
+        /// \param[out] node: node under point (only if found).
+        /// \param[in,out] stats: if not null, counter of hit is increased.
+        /// \returns True if found, false if spatial index is needed.
+        bool relocateNearby(const WalkTerrainID previous, const BoostPoint& localization, WalkTerrainID& node, RelocateStats* stats) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Get shared edge of polygons oriented along move.
+        /// 
+        /// \param[in] from: node left by agent.
+        /// \param[in] to: next node (neighbor of from).
+        /// \param[out] left: extremity on left side of move.
+        /// \param[out] right: extremity on right side of move.
+        void findPortal(const WalkTerrainID from, const WalkTerrainID to, BoostPoint& left, BoostPoint& right) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Merge polygons of nodes by pairs (cascaded union).
+        /// 
+        /// \param[in] reached: nodes to merge.
+        /// \param[out] region: union of their polygons.
+        void mergePolygons(const std::vector<ReachedNode>& reached, BoostMultiPolygon& region) const;
+
+        //------------------------------------------------------------------------
+        /// \brief  Copy current overlay, apply change then publish it with next version.
+        /// 
+        /// \param[in] change: functor editing copy.
+        template<typename Change>
+        void publishOverlay(Change change);
+
+        //------------------------------------------------------------------------
+        /// \brief  Check query then run A* with agent weight.
+        /// 
+        /// \param[in] agent: who moves (speed by terrain).
+        /// \param[in] overlay: snapshot of runtime changes (null if none).
+        /// \param[in] from: start node.
+        /// \param[in] to: goal node.
+        /// \param[in,out] context: workspace of current thread.
+        /// \param[in] speedMode: use only distance as weight.
+        /// \param[in] heuristic: functor to estimate cost from node to goal.
+        /// \returns Goal found and number of examined nodes.
+        template<typename Heuristic>
+        SearchResult searchWithHeuristic(const Agent& agent, const CostOverlay* overlay, const WalkTerrainID from, const WalkTerrainID to, PathSearchContext& context, bool speedMode, Heuristic heuristic) const;
+
         QuadTree                _quadTree;      ///< Speed data to get where agent is in world.
+        IndexType               _indexType;     ///< Structure used by locate().
+        GridIndex               _grid;          ///< Grid of polygon boxes (only for grid index).
         TerrainGraph            _worldGraph;    ///< All connexion in world (road, terrain).
+        std::vector<WalkTerrain>    _walkTerrains;  ///< [OWNERSHIP] Full data of each node (indexed by WalkTerrainID).
+        PathSearchContext       _context;       ///< Workspace of computePath() without context.
+        mutable PathCache       _pathCache;     ///< Routes already computed (thread-safe).
+
+        std::shared_ptr<const CostOverlay>  _overlay;       ///< [OWNERSHIP] Runtime changes (atomic access only, null if none).
+        std::mutex                          _overlayMutex;  ///< Serialize writers of overlay.
+
+        //----------------------------------------------------------------------------
+        /// \brief Edges of all polygons stored by field (see isInsidePolygon()).
+        struct PolygonEdges
+        {
+            std::vector<BT::uint32> _offsets;   ///< First edge of each node (size = nodes + 1).
+            std::vector<float>      _x0;        ///< Abscissa of first point.
+            std::vector<float>      _y0;        ///< Ordinate of first point.
+            std::vector<float>      _y1;        ///< Ordinate of second point.
+            std::vector<float>      _slope;     ///< dx / dy (0 for horizontal edge).
+        };
+
+        PolygonEdges                _edges;         ///< [OWNERSHIP] Flattened polygons for batch location.
 
         std::vector<BoostPoint>     _points;        ///< [OWNERSHIP]
 };
@@ -0,0 +1,86 @@
+#include "TerrainGraph.h"
+
+TerrainGraph::NodeID TerrainGraph::addNode(const BoostPoint& centroid, const Type type, const float height, const BT::uint16 subgraphID)
+{
+    BT_PRE_CONDITION(_offsets.empty());    // DEV Issue: finalize() already called !
+    BT_PRE_CONDITION(type < NbType);       // DEV Issue: Check valid data !
+
+    _centroids.emplace_back(centroid);
+    _types.emplace_back(static_cast<BT::uint8>(type));
+    _heights.emplace_back(height);
+    _subgraphIDs.emplace_back(subgraphID);
+
+    return static_cast<NodeID>(_centroids.size() - 1);
+}
+
+void TerrainGraph::addLink(const NodeID node0, const NodeID node1, const float distance)
+{
+    BT_PRE_CONDITION(_offsets.empty());            // DEV Issue: finalize() already called !
+    BT_PRE_CONDITION(node0 < _centroids.size());   // DEV Issue: Invalid input !
+    BT_PRE_CONDITION(node1 < _centroids.size());   // DEV Issue: Invalid input !
+
+    _links.push_back({ node0, node1, distance });
+}
+
+void TerrainGraph::finalize()
+{
+    BT_PRE_CONDITION(_offsets.empty());    // DEV Issue: finalize() already called !
+    BT_PRE_CONDITION(!_centroids.empty()); // DEV Issue: No node !
+
+    const size_t nbNodes = _centroids.size();
+
+    // Count out edges of each node (shift by one to get offsets after prefix sum)
+    _offsets.assign(nbNodes + 1, 0);
+    for(const auto& link : _links)
+    {
+        ++_offsets[link._node0 + 1];
+        ++_offsets[link._node1 + 1];
+    }
+    for(size_t node = 0; node < nbNodes; ++node)
+    {
+        _offsets[node + 1] += _offsets[node];
+    }
+
+    // Fill edges keeping file order for each node
+    _targets.resize(_offsets.back());
+    _distances.resize(_offsets.back());
+    _reverseEdges.resize(_offsets.back());
+    std::vector<EdgeID> cursors(_offsets.begin(), _offsets.end() - 1);
+    for(const auto& link : _links)
+    {
+        const EdgeID edge0 = cursors[link._node0]++;
+        _targets[edge0]   = link._node1;
+        _distances[edge0] = link._distance;
+
+        const EdgeID edge1 = cursors[link._node1]++;
+        _targets[edge1]   = link._node0;
+        _distances[edge1] = link._distance;
+
+        _reverseEdges[edge0] = edge1;
+        _reverseEdges[edge1] = edge0;
+    }
+
+    // Heuristic factor (0 if no edge has length)
+    _minDistanceRatio = std::numeric_limits<float>::infinity();
+    for(const auto& link : _links)
+    {
+        const float straight = static_cast<float>(bg::distance(_centroids[link._node0], _centroids[link._node1]));
+        if(straight > 0.0f)
+            _minDistanceRatio = std::min(_minDistanceRatio, link._distance / straight);
+    }
+    if(_minDistanceRatio == std::numeric_limits<float>::infinity())
+        _minDistanceRatio = 0.0f;
+
+    // Build data is useless now
+    std::vector<Link> empty;
+    _links.swap(empty);
+
+    BT_POST_CONDITION(_offsets.size() == nbNodes + 1);
+}
+
+void TerrainGraph::clear()
+{
+    *this = TerrainGraph();
+
+    BT_POST_CONDITION(empty());
+}
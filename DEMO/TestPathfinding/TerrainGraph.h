@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Define.h"
+
+/// Terrain type
+enum Type
+{
+    Ocean,
+    Swamp,
+    Forest,
+    Clay,
+    Linestone,
+    Sand,
+    Rock,
+    NbType
+};
+
+//----------------------------------------------------------------------------
+/// \brief Immutable graph in compressed sparse row layout.
+/// Out edges of node N are [_offsets[N], _offsets[N+1]) into _targets/_distances.
+/// Data read by search are stored by field (SoA) to stay in cache.
+/// \code{ .cpp }
+///     TerrainGraph graph;
+///     graph.addNode(centroid0, Forest, 10.0f, 1);
+///     graph.addNode(centroid1, Sand,   12.0f, 1);
+///     graph.addLink(0, 1, 5.0f);
+///     graph.finalize();
+/// \endcode
+class TerrainGraph final
+{
+    BT_NOCOPY(TerrainGraph);
+
+    public:
+        using NodeID = BT::uint32;      ///< Index of node.
+        using EdgeID = BT::uint32;      ///< Index of directed edge.
+
+        /// Constructor
+        TerrainGraph():
+        _minDistanceRatio(0.0f)
+        {}
+
+        TerrainGraph(TerrainGraph&&) = default;
+        TerrainGraph& operator=(TerrainGraph&&) = default;
+
+        /// Destructor
+        ~TerrainGraph() = default;
+
+    //------------------------------------------------------------------------------------------
+    //									Build methods
+    //------------------------------------------------------------------------------------------
+        //------------------------------------------------------------------------
+        /// \brief  Register new node (only before finalize()).
+        ///
+        /// \param[in] centroid: center of node polygon.
+        /// \param[in] type: kind of terrain.
+        /// \param[in] height: altitude of terrain.
+        /// \param[in] subgraphID: connectivity group.
+        /// \returns ID of new node.
+        NodeID addNode(const BoostPoint& centroid, const Type type, const float height, const BT::uint16 subgraphID);
+
+        //------------------------------------------------------------------------
+        /// \brief  Register link in both directions (only before finalize()).
+        ///
+        /// \param[in] node0: first node.
+        /// \param[in] node1: second node.
+        /// \param[in] distance: distance between centroids.
+        void addLink(const NodeID node0, const NodeID node1, const float distance);
+
+        //------------------------------------------------------------------------
+        /// \brief  Build CSR arrays from registered links. Graph can't be edited after.
+        ///
+        void finalize();
+
+        //------------------------------------------------------------------------
+        /// \brief  Release all data.
+        ///
+        void clear();
+
+    //------------------------------------------------------------------------------------------
+    //									Getter methods
+    //------------------------------------------------------------------------------------------
+        bool empty() const
+        {
+            return _centroids.empty();
+        }
+
+        size_t getNbNodes() const
+        {
+            return _centroids.size();
+        }
+
+        size_t getNbEdges() const
+        {
+            return _targets.size();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get first out edge of node.
+        ///
+        /// \param[in] node: source node.
+        /// \returns First edge ID.
+        EdgeID beginEdge(const NodeID node) const
+        {
+            BT_PRE_CONDITION(node + 1 < _offsets.size());
+            return _offsets[node];
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get past-the-end out edge of node.
+        ///
+        /// \param[in] node: source node.
+        /// \returns Last edge ID + 1.
+        EdgeID endEdge(const NodeID node) const
+        {
+            BT_PRE_CONDITION(node + 1 < _offsets.size());
+            return _offsets[node + 1];
+        }
+
+        NodeID getTarget(const EdgeID edge) const
+        {
+            BT_PRE_CONDITION(edge < _targets.size());
+            return _targets[edge];
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get edge going back (target -> source of edge).
+        ///
+        /// \param[in] edge: directed edge.
+        /// \returns Twin edge ID.
+        EdgeID getReverseEdge(const EdgeID edge) const
+        {
+            BT_PRE_CONDITION(edge < _reverseEdges.size());
+            return _reverseEdges[edge];
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get lowest ratio between distance of edge and distance between centroids.
+        ///
+        /// \returns Factor so that factor * straight distance never overestimates path distance.
+        float getMinDistanceRatio() const
+        {
+            return _minDistanceRatio;
+        }
+
+        float getDistance(const EdgeID edge) const
+        {
+            BT_PRE_CONDITION(edge < _distances.size());
+            return _distances[edge];
+        }
+
+        const BoostPoint& getCentroid(const NodeID node) const
+        {
+            BT_PRE_CONDITION(node < _centroids.size());
+            return _centroids[node];
+        }
+
+        Type getType(const NodeID node) const
+        {
+            BT_PRE_CONDITION(node < _types.size());
+            return static_cast<Type>(_types[node]);
+        }
+
+        float getHeight(const NodeID node) const
+        {
+            BT_PRE_CONDITION(node < _heights.size());
+            return _heights[node];
+        }
+
+        BT::uint16 getSubgraphID(const NodeID node) const
+        {
+            BT_PRE_CONDITION(node < _subgraphIDs.size());
+            return _subgraphIDs[node];
+        }
+
+    private:
+        //----------------------------------------------------------------------------
+        /// \brief Link read from file (build only).
+        struct Link
+        {
+            NodeID  _node0;
+            NodeID  _node1;
+            float   _distance;
+        };
+
+        // CSR
+        std::vector<EdgeID>     _offsets;       ///< [OWNERSHIP] First edge of each node (size = nodes + 1).
+        std::vector<NodeID>     _targets;       ///< [OWNERSHIP] Target node of each edge.
+        std::vector<float>      _distances;     ///< [OWNERSHIP] Distance of each edge.
+        std::vector<EdgeID>     _reverseEdges;  ///< [OWNERSHIP] Twin edge of each edge.
+        float                   _minDistanceRatio;  ///< Lowest distance / straight distance of edges.
+
+        // Nodes (SoA)
+        std::vector<BoostPoint> _centroids;     ///< [OWNERSHIP] Center of polygon.
+        std::vector<BT::uint8>  _types;         ///< [OWNERSHIP] Type of terrain.
+        std::vector<float>      _heights;       ///< [OWNERSHIP] Height of terrain.
+        std::vector<BT::uint16> _subgraphIDs;   ///< [OWNERSHIP] Connectivity group.
+
+        std::vector<Link>       _links;         ///< [OWNERSHIP] Pending links until finalize().
+};
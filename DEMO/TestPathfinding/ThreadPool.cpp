@@ -0,0 +1,146 @@
+#include "ThreadPool.h"
+
+namespace BT
+{
+
+ThreadPool::ThreadPool(const size_t nbWorkers):
+_nbQueued(0), _nextQueue(0), _stop(false)
+{
+    const size_t nbThreads = nbWorkers > 0 ? nbWorkers : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    _queues.reserve(nbThreads);
+    for(size_t workerID = 0; workerID < nbThreads; ++workerID)
+    {
+        _queues.emplace_back(std::make_unique<Queue>());
+    }
+
+    // Start when all queues exist (workers can steal everywhere)
+    _threads.reserve(nbThreads);
+    for(size_t workerID = 0; workerID < nbThreads; ++workerID)
+    {
+        _threads.emplace_back(&ThreadPool::run, this, workerID);
+    }
+
+    BT_POST_CONDITION(getNbWorkers() == nbThreads);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeUp.notify_all();
+
+    for(auto& thread : _threads)
+    {
+        thread.join();
+    }
+
+    BT_POST_CONDITION(_nbQueued == 0);
+}
+
+void ThreadPool::submit(Task&& task)
+{
+    BT_PRE_CONDITION(task);
+
+    Queue& queue = *_queues[_nextQueue++ % _queues.size()];
+    {
+        // Counter is changed with task: popTask() never decrements before it
+        std::lock_guard<std::mutex> lock(queue._mutex);
+        queue._tasks.emplace_back(std::move(task));
+        ++_nbQueued;
+    }
+
+    // Sleeping worker checks counter under lock: never lose wake up
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _wakeUp.notify_one();
+}
+
+void ThreadPool::parallelFor(const size_t nbItems, const std::function<void(size_t)>& job)
+{
+    if(nbItems == 0)
+        return;
+
+    // Several chunks by worker: stealing balances long and short items
+    const size_t grain    = std::max<size_t>(1, nbItems / (getNbWorkers() * 8));
+    const size_t nbChunks = (nbItems + grain - 1) / grain;
+
+    std::mutex              mutex;
+    std::condition_variable finished;
+    size_t                  nbRunning = nbChunks;
+
+    for(size_t begin = 0; begin < nbItems; begin += grain)
+    {
+        const size_t end = std::min(nbItems, begin + grain);
+        submit([&, begin, end]()
+        {
+            for(size_t item = begin; item < end; ++item)
+            {
+                job(item);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if(--nbRunning == 0)
+            {
+                finished.notify_one();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() { return nbRunning == 0; });
+}
+
+bool ThreadPool::popTask(const size_t workerID, Task& task)
+{
+    // Own queue: latest task (hot in cache)
+    {
+        Queue& queue = *_queues[workerID];
+        std::lock_guard<std::mutex> lock(queue._mutex);
+        if(!queue._tasks.empty())
+        {
+            task = std::move(queue._tasks.back());
+            queue._tasks.pop_back();
+            --_nbQueued;
+            return true;
+        }
+    }
+
+    // Steal oldest task of other workers
+    for(size_t offset = 1; offset < _queues.size(); ++offset)
+    {
+        Queue& queue = *_queues[(workerID + offset) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue._mutex);
+        if(!queue._tasks.empty())
+        {
+            task = std::move(queue._tasks.front());
+            queue._tasks.pop_front();
+            --_nbQueued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(const size_t workerID)
+{
+    while(true)
+    {
+        Task task;
+        if(popTask(workerID, task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wakeUp.wait(lock, [&]() { return _stop || _nbQueued > 0; });
+        if(_stop && _nbQueued == 0)
+            return;
+    }
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Define.h"
+
+namespace BT
+{
+    //----------------------------------------------------------------------------
+    /// \brief Pool of worker threads with one task queue per worker.
+    /// A worker takes its own tasks first (LIFO) then steals oldest tasks of
+    /// others (FIFO) so unbalanced jobs are spread without global lock.
+    /// \code{ .cpp }
+    ///     BT::ThreadPool pool(4);
+    ///     pool.parallelFor(queries.size(), [&](size_t id) { compute(queries[id]); });
+    /// \endcode
+    /// \note Never call parallelFor() from a task of same pool (deadlock).
+    class ThreadPool final
+    {
+        BT_NOCOPY_NOMOVE(ThreadPool);
+
+        public:
+            using Task = std::function<void()>;
+
+            //------------------------------------------------------------------------
+            /// \brief  Constructor: start all workers.
+            ///
+            /// \param[in] nbWorkers: number of threads (0 = hardware concurrency).
+            explicit ThreadPool(const size_t nbWorkers = 0);
+
+            /// Destructor: finish all tasks then join workers.
+            ~ThreadPool();
+
+            //------------------------------------------------------------------------
+            /// \brief  Get number of threads of pool.
+            ///
+            /// \returns Number of workers.
+            size_t getNbWorkers() const
+            {
+                return _threads.size();
+            }
+
+            //------------------------------------------------------------------------
+            /// \brief  Add task into queue of one worker (round robin).
+            ///
+            /// \param[in] task: job to execute later on any worker.
+            void submit(Task&& task);
+
+            //------------------------------------------------------------------------
+            /// \brief  Execute job for each item in [0, nbItems) and wait the end.
+            ///
+            /// \param[in] nbItems: number of item.
+            /// \param[in] job: called once by item (from any worker).
+            void parallelFor(const size_t nbItems, const std::function<void(size_t)>& job);
+
+        private:
+            //----------------------------------------------------------------------------
+            /// \brief Task queue of one worker.
+            struct Queue
+            {
+                std::deque<Task>    _tasks;     ///< Pending tasks.
+                std::mutex          _mutex;     ///< Protect _tasks.
+            };
+
+            //------------------------------------------------------------------------
+            /// \brief  Take task from own queue or steal from other.
+            ///
+            /// \param[in] workerID: who asks.
+            /// \param[out] task: found task.
+            /// \returns True if a task was found, false otherwise.
+            bool popTask(const size_t workerID, Task& task);
+
+            //------------------------------------------------------------------------
+            /// \brief  Main loop of worker thread.
+            ///
+            /// \param[in] workerID: index of worker.
+            void run(const size_t workerID);
+
+            std::vector<std::unique_ptr<Queue>> _queues;        ///< [OWNERSHIP] One queue by worker.
+            std::vector<std::thread>            _threads;       ///< [OWNERSHIP] Workers.
+
+            std::mutex                          _mutex;         ///< Protect sleep/wake up.
+            std::condition_variable             _wakeUp;        ///< Signal new task or stop.
+            std::atomic<size_t>                 _nbQueued;      ///< Tasks not yet taken by worker.
+            std::atomic<size_t>                 _nextQueue;     ///< Round robin of submit().
+            bool                                _stop;          ///< Destructor called.
+    };
+}
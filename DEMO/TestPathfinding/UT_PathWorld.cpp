@@ -1,7 +1,15 @@
 #include "gtest/gtest.h"
 
+#include "ClusterGraph.h"
+#include "ContractionHierarchy.h"
 #include "File.h"
+#include "Landmarks.h"
+#include "PathReplanner.h"
+#include "PathScheduler.h"
+#include "PathService.h"
 #include "PathWorld.h"
+#include "ThreadPool.h"
+#include "WeightProfile.h"
 
 //#define DEBUG_PRINT
 
@@ -14,12 +22,12 @@ class PathWorldTest : public ::testing::Test
         static void TearDownTestCase()
         {}
 
-        void read(const BT::StringOS& fileMap, PathWorld& path)
+        void read(const BT::StringOS& fileMap, PathWorld& path, PathWorld::IndexType index = PathWorld::IndexType::RTree)
         {
             // Build data
             BT::File file(fileMap);
             ASSERT_NO_THROW(file.open());
-            ASSERT_NO_THROW(path.initialize(file));
+            ASSERT_NO_THROW(path.initialize(file, index));
             ASSERT_NO_THROW(file.close());
         }
 
@@ -81,6 +89,42 @@ class PathWorldTest : public ::testing::Test
             std::cout << "  mean: " << sumTime / nbValid << " ms" << std::endl;
             std::cout << "  Global time: " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()-startCompute).count() << " ms" << std::endl;
         }
+
+        // Reference: Dijkstra on full graph (infinity when not reachable)
+        void computeCosts(const PathWorld& path, const Agent& agent, const PathWorld::WalkTerrainID from, std::vector<float>& costs, bool speedMode = false)
+        {
+            computeCosts(path.getGraph(), from, costs, [&](PathWorld::WalkTerrainID node, TerrainGraph::EdgeID edge)
+            {
+                return speedMode ? path.updateSpeedWeight(edge) : path.updateWeight(agent, node, edge);
+            });
+        }
+
+        template<typename WeightFunctor>
+        void computeCosts(const TerrainGraph& graph, const PathWorld::WalkTerrainID from, std::vector<float>& costs, WeightFunctor weight)
+        {
+            costs.assign(graph.getNbNodes(), std::numeric_limits<float>::infinity());
+
+            using Entry = std::pair<float, PathWorld::WalkTerrainID>;
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+            costs[from] = 0.0f;
+            queue.emplace(0.0f, from);
+            while(!queue.empty())
+            {
+                const Entry current = queue.top();
+                queue.pop();
+                if(current.first > costs[current.second])
+                    continue;
+                for(TerrainGraph::EdgeID edge = graph.beginEdge(current.second); edge != graph.endEdge(current.second); ++edge)
+                {
+                    const float cost = current.first + weight(current.second, edge);
+                    if(cost < costs[graph.getTarget(edge)])
+                    {
+                        costs[graph.getTarget(edge)] = cost;
+                        queue.emplace(cost, graph.getTarget(edge));
+                    }
+                }
+            }
+        }
 };
 
 TEST_F(PathWorldTest, EASY_computePath)
@@ -123,4 +167,2286 @@ TEST_F(PathWorldTest, COMPLEX_computePath)
     computePath(path, 3067, 15000);
 
     ASSERT_NO_THROW(path.release());
-}
\ No newline at end of file
+}
+
+TEST_F(PathWorldTest, COMPLEX_computePathWithContext)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    PathSearchContext context;
+
+    // Same context is reused for all queries: result must be same as without context.
+    const PathWorld::WalkTerrainID n0 = static_cast<PathWorld::WalkTerrainID>(1050);
+    for(size_t query = 0; query < 500; ++query)
+    {
+        const PathWorld::WalkTerrainID n1 = static_cast<PathWorld::WalkTerrainID>(1050 + query);
+
+        std::vector<BoostPoint> pathWayRef;
+        std::vector<BoostPoint> pathWay;
+        bool validRef = false;
+        bool valid    = false;
+        ASSERT_NO_THROW(validRef = path.computePath(newAgent, n0, n1, pathWayRef));
+        ASSERT_NO_THROW(valid    = path.computePath(newAgent, n0, n1, pathWay, context));
+
+        ASSERT_EQ(validRef, valid);
+        ASSERT_EQ(pathWayRef.size(), pathWay.size());
+        for(size_t id = 0; id < pathWay.size(); ++id)
+        {
+            EXPECT_TRUE(bg::equals(pathWayRef[id], pathWay[id]));
+        }
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, SMALL_searchPath)
+{
+    PathWorld path;
+    read(L"map/Map_small.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    PathSearchContext context;
+
+    // Start is goal: only one examined node
+    PathWorld::SearchResult result{ false, 0, 0.0f };
+    ASSERT_NO_THROW(result = path.searchPath(newAgent, 60, 60, context));
+    EXPECT_TRUE(result._found);
+    EXPECT_EQ(1u, result._nbExpansions);
+
+    for(PathWorld::WalkTerrainID n1 = 60; n1 < 220; ++n1)
+    {
+        std::vector<BoostPoint> pathWay;
+        ASSERT_NO_THROW(result = path.searchPath(newAgent, 60, n1, context));
+        if(result._found)
+        {
+            EXPECT_LE(1u, result._nbExpansions);
+            ASSERT_NO_THROW(path.extractPath(n1, context, pathWay));
+            EXPECT_FALSE(pathWay.empty());
+        }
+        else
+        {
+            EXPECT_FALSE(path.computePath(newAgent, 60, n1, pathWay, context));
+        }
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, SMALL_graph)
+{
+    PathWorld path;
+    read(L"map/Map_small.map", path);
+
+    const TerrainGraph& graph = path.getGraph();
+    ASSERT_LT(0u, graph.getNbNodes());
+    ASSERT_LT(0u, graph.getNbEdges());
+
+    for(TerrainGraph::NodeID node = 0; node < graph.getNbNodes(); ++node)
+    {
+        // Hot data is same as full node
+        const PathWorld::WalkTerrain& walkTerrain = path.getWalkTerrain(node);
+        EXPECT_EQ(walkTerrain._terrain._type,   graph.getType(node));
+        EXPECT_EQ(walkTerrain._terrain._height, graph.getHeight(node));
+        EXPECT_EQ(walkTerrain._subgraphID,      graph.getSubgraphID(node));
+
+        // Each edge exists in both directions with same distance
+        for(TerrainGraph::EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+        {
+            const TerrainGraph::NodeID target = graph.getTarget(edge);
+            EXPECT_EQ(graph.getSubgraphID(node), graph.getSubgraphID(target));
+
+            bool reverse = false;
+            for(TerrainGraph::EdgeID back = graph.beginEdge(target); back != graph.endEdge(target); ++back)
+            {
+                reverse |= graph.getTarget(back) == node && graph.getDistance(back) == graph.getDistance(edge);
+            }
+            EXPECT_TRUE(reverse);
+        }
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_computePaths)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+
+    // Same workload as COMPLEX_computePath
+    std::vector<PathWorld::PathQuery> queries;
+    const std::array<std::pair<size_t, size_t>, 3> workloads = { { { 550, 15000 }, { 1050, 1500 }, { 3251, 1000 } } };
+    for(const auto& workload : workloads)
+    {
+        for(size_t query = 0; query < workload.second && workload.first + query < path.getGraph().getNbNodes(); ++query)
+        {
+            queries.push_back({ &newAgent, static_cast<PathWorld::WalkTerrainID>(workload.first), static_cast<PathWorld::WalkTerrainID>(workload.first + query), false, PathWorld::SearchMode::Forward });
+        }
+    }
+
+    // Reference: one thread
+    std::vector<PathWorld::PathResult> reference(queries.size());
+    PathSearchContext context;
+    for(size_t queryID = 0; queryID < queries.size(); ++queryID)
+    {
+        reference[queryID]._valid = path.computePath(newAgent, queries[queryID]._from, queries[queryID]._to, reference[queryID]._pathWay, context);
+    }
+
+    std::cout << std::endl << "Batch of " << queries.size() << " queries:" << std::endl;
+    const size_t nbCores = std::max<size_t>(4, std::thread::hardware_concurrency());
+    for(size_t nbWorkers = 1; nbWorkers <= nbCores; nbWorkers *= 2)
+    {
+        BT::ThreadPool pool(nbWorkers);
+        std::vector<PathWorld::PathResult> results(queries.size());
+
+        const auto startTime = std::chrono::system_clock::now();
+        ASSERT_NO_THROW(path.computePaths(queries, results, pool));
+        const auto endTime = std::chrono::system_clock::now();
+        std::cout << "  " << nbWorkers << " worker(s): " << std::chrono::duration_cast<std::chrono::milliseconds>(endTime-startTime).count() << " ms" << std::endl;
+
+        for(size_t queryID = 0; queryID < queries.size(); ++queryID)
+        {
+            ASSERT_EQ(reference[queryID]._valid,          results[queryID]._valid);
+            ASSERT_EQ(reference[queryID]._pathWay.size(), results[queryID]._pathWay.size());
+        }
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_contractionHierarchy)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+
+    const auto startBuild = std::chrono::system_clock::now();
+    ContractionHierarchy hierarchy;
+    ASSERT_NO_THROW(hierarchy.build(path, newAgent.getNavigation()));
+    std::cout << std::endl << "Contraction hierarchy: " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()-startBuild).count() << " ms, "
+              << hierarchy.getNbShortcuts() << " shortcuts" << std::endl;
+
+    std::vector<float> costs;
+    PathSearchContext context;
+    size_t nbValid = 0;
+    size_t sumExpansions = 0;
+    std::chrono::system_clock::duration sumTime(0);
+    for(const PathWorld::WalkTerrainID n0 : { 1050u, 3251u, 550u })
+    {
+        computeCosts(path, newAgent, n0, costs);
+        for(PathWorld::WalkTerrainID n1 = 0; n1 < graph.getNbNodes(); n1 += 7)
+        {
+            std::vector<BoostPoint> pathWay;
+            PathWorld::SearchResult result{ false, 0, 0.0f };
+
+            const auto startTime = std::chrono::system_clock::now();
+            ASSERT_NO_THROW(result = hierarchy.computePath(n0, n1, pathWay, context));
+            sumTime += std::chrono::system_clock::now() - startTime;
+
+            ASSERT_EQ(costs[n1] != std::numeric_limits<float>::infinity(), result._found);
+            if(result._found)
+            {
+                ++nbValid;
+                sumExpansions += result._nbExpansions;
+                EXPECT_NEAR(costs[n1], result._cost, 1e-3f * std::max(1.0f, costs[n1]));
+
+                // Unpacked path: goal first, start last, only neighbor nodes
+                ASSERT_FALSE(pathWay.empty());
+                EXPECT_TRUE(bg::equals(graph.getCentroid(n1), pathWay.front()));
+                EXPECT_TRUE(bg::equals(graph.getCentroid(n0), pathWay.back()));
+
+                std::vector<BoostPoint> pathWayWorld;
+                ASSERT_TRUE(path.computePath(hierarchy, n0, n1, pathWayWorld, context));
+                EXPECT_EQ(pathWay.size(), pathWayWorld.size());
+            }
+        }
+    }
+    ASSERT_LT(0u, nbValid);
+    std::cout << "  nbValid: " << nbValid << std::endl;
+    std::cout << "  mean settled nodes: " << sumExpansions / nbValid << std::endl;
+    std::cout << "  mean time: " << std::chrono::duration_cast<std::chrono::microseconds>(sumTime).count() / nbValid << " us" << std::endl;
+
+    ASSERT_NO_THROW(hierarchy.release());
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_landmarks)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+
+    const auto startBuild = std::chrono::system_clock::now();
+    Landmarks landmarks;
+    ASSERT_NO_THROW(landmarks.build(path, newAgent.getNavigation(), 8));
+    std::cout << std::endl << "Landmarks: " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()-startBuild).count() << " ms" << std::endl;
+
+    std::vector<float> costs;
+    PathSearchContext context;
+    for(const PathWorld::WalkTerrainID n0 : { 1050u, 3251u })
+    {
+        computeCosts(path, newAgent, n0, costs);
+
+        size_t nbValid = 0;
+        size_t sumAlt = 0;
+        size_t sumEuclidean = 0;
+        size_t sumDijkstra = 0;
+        for(PathWorld::WalkTerrainID n1 = 0; n1 < graph.getNbNodes(); n1 += 11)
+        {
+            PathWorld::SearchResult result{ false, 0, 0.0f };
+            ASSERT_NO_THROW(result = path.searchPath(newAgent, landmarks, n0, n1, context));
+            ASSERT_EQ(costs[n1] != std::numeric_limits<float>::infinity(), result._found);
+            if(!result._found)
+                continue;
+
+            // Optimal path
+            ++nbValid;
+            EXPECT_NEAR(costs[n1], result._cost, 1e-3f * std::max(1.0f, costs[n1]));
+            sumAlt += result._nbExpansions;
+
+            // Dijkstra settles all nodes closer than goal
+            sumDijkstra += std::count_if(costs.begin(), costs.end(), [&](float cost) { return cost <= costs[n1]; });
+
+            ASSERT_NO_THROW(result = path.searchPath(newAgent, n0, n1, context));
+            sumEuclidean += result._nbExpansions;
+
+            std::vector<BoostPoint> pathWay;
+            ASSERT_TRUE(path.computePath(newAgent, landmarks, n0, n1, pathWay, context));
+            EXPECT_TRUE(bg::equals(graph.getCentroid(n0), pathWay.back()));
+        }
+        ASSERT_LT(0u, nbValid);
+
+        std::cout << "  Start " << n0 << " (" << nbValid << " paths) mean expansions:" << std::endl;
+        std::cout << "    Dijkstra:          " << sumDijkstra  / nbValid << std::endl;
+        std::cout << "    ALT:               " << sumAlt       / nbValid << std::endl;
+        std::cout << "    Squared euclidean: " << sumEuclidean / nbValid << " (not optimal)" << std::endl;
+    }
+
+    ASSERT_NO_THROW(landmarks.release());
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_clusterGraph)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+
+    std::vector<std::vector<float>> costs(2);
+    const PathWorld::WalkTerrainID starts[] = { 1050u, 3251u };
+    computeCosts(path, newAgent, starts[0], costs[0]);
+    computeCosts(path, newAgent, starts[1], costs[1]);
+
+    PathSearchContext context;
+    for(const size_t nodesByCluster : { 64u, 256u, 1024u })
+    {
+        const auto startBuild = std::chrono::system_clock::now();
+        ClusterGraph clusters;
+        ASSERT_NO_THROW(clusters.build(path, newAgent.getNavigation(), nodesByCluster));
+        std::cout << std::endl << "Clusters (" << nodesByCluster << " nodes by cell): " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now()-startBuild).count() << " ms, "
+                  << clusters.getNbClusters() << " clusters, " << clusters.getNbPortals() << " portals, " << clusters.getNbAbstractArcs() << " arcs" << std::endl;
+
+        size_t nbValid = 0;
+        size_t sumExpansions = 0;
+        std::chrono::nanoseconds duration(0);
+        for(size_t startID = 0; startID < 2; ++startID)
+        {
+            const PathWorld::WalkTerrainID n0 = starts[startID];
+            for(PathWorld::WalkTerrainID n1 = 0; n1 < graph.getNbNodes(); n1 += 11)
+            {
+                std::vector<BoostPoint> pathWay;
+                const auto start = std::chrono::steady_clock::now();
+                const PathWorld::SearchResult result = clusters.computePath(n0, n1, pathWay, context);
+                duration += std::chrono::steady_clock::now() - start;
+
+                const float cost = costs[startID][n1];
+                ASSERT_EQ(cost != std::numeric_limits<float>::infinity(), result._found);
+                if(!result._found)
+                    continue;
+
+                // Optimal path
+                ++nbValid;
+                sumExpansions += result._nbExpansions;
+                EXPECT_NEAR(cost, result._cost, 1e-3f * std::max(1.0f, cost));
+                EXPECT_TRUE(bg::equals(graph.getCentroid(n1), pathWay.front()));
+                EXPECT_TRUE(bg::equals(graph.getCentroid(n0), pathWay.back()));
+            }
+        }
+        ASSERT_LT(0u, nbValid);
+        std::cout << "  nbValid: " << nbValid << std::endl;
+        std::cout << "  mean expansions: " << sumExpansions / nbValid << std::endl;
+        std::cout << "  mean time: " << std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / nbValid << " us" << std::endl;
+
+        std::vector<BoostPoint> pathWay;
+        ASSERT_TRUE(path.computePath(clusters, starts[0], starts[1], pathWay, context));
+
+        ASSERT_NO_THROW(clusters.release());
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_bidirectional)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+
+    std::vector<float> costs;
+    PathSearchContext context;
+    for(const bool speedMode : { false, true })
+    {
+        std::cout << std::endl << (speedMode ? "Speed mode:" : "Agent weight:") << std::endl;
+        for(const PathWorld::WalkTerrainID n0 : { 1050u, 3251u })
+        {
+            computeCosts(path, newAgent, n0, costs, speedMode);
+
+            size_t nbValid = 0;
+            size_t sumForward = 0;
+            size_t sumBidirectional = 0;
+            size_t sumDijkstra = 0;
+            for(PathWorld::WalkTerrainID n1 = 0; n1 < graph.getNbNodes(); n1 += 11)
+            {
+                PathWorld::SearchResult result{ false, 0, 0.0f };
+                ASSERT_NO_THROW(result = path.searchPath(newAgent, n0, n1, context, speedMode, PathWorld::SearchMode::Bidirectional));
+                ASSERT_EQ(costs[n1] != std::numeric_limits<float>::infinity(), result._found);
+                if(!result._found)
+                    continue;
+
+                // Optimal path and whole path readable from context
+                ++nbValid;
+                EXPECT_NEAR(costs[n1], result._cost, 1e-3f * std::max(1.0f, costs[n1]));
+                EXPECT_NEAR(costs[n1], context.getCost(n1), 1e-3f * std::max(1.0f, costs[n1]));
+                sumBidirectional += result._nbExpansions;
+
+                std::vector<BoostPoint> pathWay;
+                ASSERT_NO_THROW(path.extractPath(n1, context, pathWay));
+                EXPECT_TRUE(bg::equals(graph.getCentroid(n1), pathWay.front()));
+                EXPECT_TRUE(bg::equals(graph.getCentroid(n0), pathWay.back()));
+
+                // Unidirectional searches
+                sumDijkstra += std::count_if(costs.begin(), costs.end(), [&](float cost) { return cost <= costs[n1]; });
+                ASSERT_NO_THROW(result = path.searchPath(newAgent, n0, n1, context, speedMode));
+                sumForward += result._nbExpansions;
+            }
+            ASSERT_LT(0u, nbValid);
+
+            // Same start and goal: one point path
+            PathWorld::SearchResult result{ false, 0, 0.0f };
+            ASSERT_NO_THROW(result = path.searchPath(newAgent, n0, n0, context, speedMode, PathWorld::SearchMode::Bidirectional));
+            EXPECT_TRUE(result._found);
+            EXPECT_EQ(0.0f, result._cost);
+            std::vector<BoostPoint> pathWay;
+            ASSERT_NO_THROW(path.extractPath(n0, context, pathWay));
+            ASSERT_EQ(1u, pathWay.size());
+            EXPECT_TRUE(bg::equals(graph.getCentroid(n0), pathWay.front()));
+            pathWay.clear();
+            ASSERT_TRUE(path.computePath(newAgent, n0, n0, pathWay, context, speedMode, PathWorld::SearchMode::Bidirectional));
+            ASSERT_EQ(1u, pathWay.size());
+
+            std::cout << "  Start " << n0 << " (" << nbValid << " paths) mean expansions:" << std::endl;
+            std::cout << "    Dijkstra:              " << sumDijkstra      / nbValid << std::endl;
+            std::cout << "    Bidirectional:         " << sumBidirectional / nbValid << " (saved " << 100 - 100 * sumBidirectional / sumDijkstra << "% of Dijkstra)" << std::endl;
+            std::cout << "    Forward (not optimal): " << sumForward       / nbValid << std::endl;
+        }
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_pathCache)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    Agent otherAgent({ 10.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    PathCache& cache = path.getPathCache();
+
+    // Same routes asked by many agents
+    std::vector<PathWorld::PathQuery> queries;
+    for(PathWorld::WalkTerrainID n1 = 1500; n1 < 1600; ++n1)
+    {
+        queries.push_back({ &newAgent, 1050u, n1, false, PathWorld::SearchMode::Forward });
+    }
+
+    BT::ThreadPool pool(4);
+    std::vector<PathWorld::PathResult> results(queries.size());
+    const auto computeAll = [&]()
+    {
+        pool.parallelFor(queries.size(), [&](size_t queryID)
+        {
+            results[queryID]._pathWay.clear();
+            results[queryID]._valid = path.computeCachedPath(*queries[queryID]._agent, queries[queryID]._from, queries[queryID]._to, results[queryID]._pathWay, PathSearchContext::getThreadContext());
+        });
+    };
+
+    computeAll();
+    EXPECT_EQ(0u, cache.getNbHits());
+    EXPECT_EQ(queries.size(), cache.getNbMisses());
+    const size_t nbEntries = cache.getNbEntries();
+    EXPECT_LT(0u, nbEntries);
+
+    const auto start = std::chrono::steady_clock::now();
+    computeAll();
+    std::cout << std::endl << "Cached batch: " << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() << " us" << std::endl;
+    EXPECT_EQ(nbEntries, cache.getNbHits());
+    EXPECT_EQ(queries.size() * 2 - nbEntries, cache.getNbMisses());
+
+    // Same result as search
+    PathSearchContext context;
+    for(size_t queryID = 0; queryID < queries.size(); ++queryID)
+    {
+        std::vector<BoostPoint> pathWay;
+        ASSERT_EQ(results[queryID]._valid, path.computePath(newAgent, queries[queryID]._from, queries[queryID]._to, pathWay, context));
+        ASSERT_EQ(results[queryID]._pathWay.size(), pathWay.size());
+        for(size_t pointID = 0; pointID < pathWay.size(); ++pointID)
+        {
+            EXPECT_TRUE(bg::equals(results[queryID]._pathWay[pointID], pathWay[pointID]));
+        }
+    }
+
+    // Other profile or mode never reads same entry
+    std::vector<BoostPoint> pathWay;
+    const BT::uint64 nbHits = cache.getNbHits();
+    ASSERT_TRUE(path.computeCachedPath(otherAgent, 1050u, 1500u, pathWay, context));
+    pathWay.clear();
+    ASSERT_TRUE(path.computeCachedPath(newAgent, 1050u, 1500u, pathWay, context, true));
+    pathWay.clear();
+    ASSERT_TRUE(path.computeCachedPath(newAgent, 1050u, 1500u, pathWay, context, false, PathWorld::SearchMode::Bidirectional));
+    EXPECT_EQ(nbHits, cache.getNbHits());
+
+    // Bounded memory
+    cache.setCapacity(200);
+    EXPECT_GE(200u, cache.getNbNodes());
+    EXPECT_GT(nbEntries, cache.getNbEntries());
+
+    ASSERT_NO_THROW(path.release());
+    EXPECT_EQ(0u, cache.getNbEntries());
+    EXPECT_EQ(0u, cache.getNbHits());
+}
+
+TEST_F(PathWorldTest, COMPLEX_weightProfile)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+
+    for(const bool speedMode : { false, true })
+    {
+        WeightProfile profile;
+        const auto startBuild = std::chrono::steady_clock::now();
+        ASSERT_NO_THROW(profile.build(path, newAgent.getNavigation(), speedMode));
+        std::cout << std::endl << (speedMode ? "Speed mode" : "Agent weight") << " profile: " << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startBuild).count() << " us" << std::endl;
+        ASSERT_TRUE(profile.isCompatible(path, newAgent.getNavigation(), speedMode));
+
+        // Same weight as on the fly
+        for(PathWorld::WalkTerrainID node = 0; node < graph.getNbNodes(); ++node)
+        {
+            for(TerrainGraph::EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+            {
+                ASSERT_EQ(speedMode ? path.updateSpeedWeight(edge) : path.updateWeight(newAgent, node, edge), profile.getWeight(edge));
+            }
+        }
+
+        // Same paths
+        PathSearchContext context;
+        std::chrono::nanoseconds durationAgent(0);
+        std::chrono::nanoseconds durationProfile(0);
+        for(const PathWorld::WalkTerrainID n0 : { 550u, 1050u, 3251u })
+        {
+            for(PathWorld::WalkTerrainID n1 = 0; n1 < graph.getNbNodes(); n1 += 7)
+            {
+                auto start = std::chrono::steady_clock::now();
+                const PathWorld::SearchResult reference = path.searchPath(newAgent, n0, n1, context, speedMode);
+                durationAgent += std::chrono::steady_clock::now() - start;
+
+                start = std::chrono::steady_clock::now();
+                const PathWorld::SearchResult result = path.searchPath(profile, n0, n1, context);
+                durationProfile += std::chrono::steady_clock::now() - start;
+
+                ASSERT_EQ(reference._found, result._found);
+                EXPECT_EQ(reference._nbExpansions, result._nbExpansions);
+                EXPECT_EQ(reference._cost, result._cost);
+            }
+        }
+        std::cout << "  Searches with agent:   " << std::chrono::duration_cast<std::chrono::milliseconds>(durationAgent).count() << " ms" << std::endl;
+        std::cout << "  Searches with profile: " << std::chrono::duration_cast<std::chrono::milliseconds>(durationProfile).count() << " ms" << std::endl;
+
+        std::vector<BoostPoint> pathWay;
+        ASSERT_TRUE(path.computePath(profile, 1050u, 1500u, pathWay, context, PathWorld::SearchMode::Bidirectional));
+
+        ASSERT_NO_THROW(profile.release());
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_replanner)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+
+    WeightProfile profile;
+    ASSERT_NO_THROW(profile.build(path, newAgent.getNavigation()));
+    const auto weight = [&](PathWorld::WalkTerrainID, TerrainGraph::EdgeID edge) { return profile.getWeight(edge); };
+
+    const PathWorld::WalkTerrainID start = 1050;
+    const PathWorld::WalkTerrainID goal  = 3251;
+    std::vector<float> costs;
+
+    // First search: same cost as Dijkstra
+    PathReplanner planner;
+    ASSERT_NO_THROW(planner.initialize(profile, start, goal));
+    std::vector<BoostPoint> pathWay;
+    PathWorld::SearchResult result = planner.computePath(pathWay);
+    ASSERT_TRUE(result._found);
+    computeCosts(graph, start, costs, weight);
+    EXPECT_NEAR(costs[goal], result._cost, 1e-3f * costs[goal]);
+    EXPECT_TRUE(bg::equals(graph.getCentroid(goal),  pathWay.front()));
+    EXPECT_TRUE(bg::equals(graph.getCentroid(start), pathWay.back()));
+    const BT::uint32 nbInitial = result._nbExpansions;
+
+    // Find nodes of path (centroid is unique by node)
+    std::vector<PathWorld::WalkTerrainID> nodes;
+    for(const BoostPoint& point : pathWay)
+    {
+        for(PathWorld::WalkTerrainID node = 0; node < graph.getNbNodes(); ++node)
+        {
+            if(bg::equals(graph.getCentroid(node), point))
+            {
+                nodes.push_back(node);
+                break;
+            }
+        }
+    }
+    ASSERT_EQ(pathWay.size(), nodes.size());
+    std::reverse(nodes.begin(), nodes.end());
+
+    // Agent walks a quarter of path then a node in the middle of path is blocked (all edges around)
+    const PathWorld::WalkTerrainID position = nodes[nodes.size() / 4];
+    const PathWorld::WalkTerrainID blocked  = nodes[nodes.size() / 2];
+    std::vector<TerrainGraph::EdgeID> changed;
+    for(TerrainGraph::EdgeID edge = graph.beginEdge(blocked); edge != graph.endEdge(blocked); ++edge)
+    {
+        changed.push_back(edge);
+        changed.push_back(graph.getReverseEdge(edge));
+    }
+    std::vector<float> oldWeights;
+    for(const TerrainGraph::EdgeID edge : changed)
+    {
+        oldWeights.push_back(profile.getWeight(edge));
+        profile.setWeight(edge, std::numeric_limits<float>::infinity());
+    }
+
+    planner.moveTo(position);
+    planner.updateEdges(changed);
+    pathWay.clear();
+    result = planner.computePath(pathWay);
+    ASSERT_TRUE(result._found);
+    computeCosts(graph, position, costs, weight);
+    EXPECT_NEAR(costs[goal], result._cost, 1e-3f * costs[goal]);
+    EXPECT_TRUE(bg::equals(graph.getCentroid(position), pathWay.back()));
+    for(const BoostPoint& point : pathWay)
+    {
+        EXPECT_FALSE(bg::equals(graph.getCentroid(blocked), point));
+    }
+    const BT::uint32 nbRepair = result._nbExpansions;
+
+    // Same query from scratch
+    PathReplanner scratch;
+    ASSERT_NO_THROW(scratch.initialize(profile, position, goal));
+    pathWay.clear();
+    result = scratch.computePath(pathWay);
+    ASSERT_TRUE(result._found);
+    EXPECT_NEAR(costs[goal], result._cost, 1e-3f * costs[goal]);
+
+    std::cout << std::endl << "Replanner (" << nodes.size() << " nodes in path):" << std::endl;
+    std::cout << "  Initial expansions:      " << nbInitial << std::endl;
+    std::cout << "  Repair expansions:       " << nbRepair << std::endl;
+    std::cout << "  From scratch expansions: " << result._nbExpansions << std::endl;
+
+    // Node is open again: path comes back
+    for(size_t edgeID = 0; edgeID < changed.size(); ++edgeID)
+    {
+        profile.setWeight(changed[edgeID], oldWeights[edgeID]);
+    }
+    planner.updateNodes({ blocked });
+    pathWay.clear();
+    result = planner.computePath(pathWay);
+    ASSERT_TRUE(result._found);
+    computeCosts(graph, position, costs, weight);
+    EXPECT_NEAR(costs[goal], result._cost, 1e-3f * costs[goal]);
+    std::cout << "  Unblock expansions:      " << result._nbExpansions << std::endl;
+
+    ASSERT_NO_THROW(scratch.release());
+    ASSERT_NO_THROW(planner.release());
+    ASSERT_NO_THROW(profile.release());
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_costOverlay)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+    EXPECT_EQ(nullptr, path.getOverlay());
+
+    const PathWorld::WalkTerrainID start = 1050;
+    const PathWorld::WalkTerrainID goal  = 3251;
+    PathSearchContext context;
+    std::vector<float> costs;
+
+    // Reference: Dijkstra with snapshot
+    const auto checkCost = [&](const std::shared_ptr<const CostOverlay>& overlay, bool speedMode, PathWorld::SearchMode mode)
+    {
+        computeCosts(graph, start, costs, [&](PathWorld::WalkTerrainID node, TerrainGraph::EdgeID edge)
+        {
+            return speedMode ? path.updateSpeedWeight(edge, *overlay) : path.updateWeight(newAgent, node, edge, *overlay);
+        });
+        const PathWorld::SearchResult result = path.searchPath(newAgent, start, goal, context, speedMode, mode);
+        ASSERT_TRUE(result._found);
+        if(mode == PathWorld::SearchMode::Bidirectional)
+        {
+            EXPECT_NEAR(costs[goal], result._cost, 1e-3f * costs[goal]);
+        }
+        else
+        {
+            // Terrain heuristic is not admissible: valid path only
+            EXPECT_LE(costs[goal] * (1.0f - 1e-3f), result._cost);
+        }
+    };
+
+    std::vector<BoostPoint> pathWay;
+    ASSERT_TRUE(path.computeCachedPath(newAgent, start, goal, pathWay, context));
+    const std::vector<BoostPoint> original = pathWay;
+
+    // Block all edges of a node in the middle of path
+    PathWorld::WalkTerrainID blocked = 0;
+    while(!bg::equals(graph.getCentroid(blocked), original[original.size() / 2]))
+    {
+        ++blocked;
+    }
+    std::vector<TerrainGraph::EdgeID> changed;
+    for(TerrainGraph::EdgeID edge = graph.beginEdge(blocked); edge != graph.endEdge(blocked); ++edge)
+    {
+        changed.push_back(edge);
+        changed.push_back(graph.getReverseEdge(edge));
+    }
+
+    const std::shared_ptr<const CostOverlay> empty = std::make_shared<CostOverlay>(graph.getNbNodes(), graph.getNbEdges());
+    ASSERT_NO_THROW(path.blockEdges(changed));
+    const std::shared_ptr<const CostOverlay> blockedOverlay = path.getOverlay();
+    ASSERT_NE(nullptr, blockedOverlay);
+    EXPECT_EQ(1u, blockedOverlay->getVersion());
+    EXPECT_EQ(std::numeric_limits<float>::infinity(), blockedOverlay->getFactor(changed.front()));
+
+    // New version never reads old cached route
+    const BT::uint64 nbHits = path.getPathCache().getNbHits();
+    pathWay.clear();
+    ASSERT_TRUE(path.computeCachedPath(newAgent, start, goal, pathWay, context));
+    EXPECT_EQ(nbHits, path.getPathCache().getNbHits());
+    for(const BoostPoint& point : pathWay)
+    {
+        EXPECT_FALSE(bg::equals(graph.getCentroid(blocked), point));
+    }
+    for(const bool speedMode : { false, true })
+    {
+        checkCost(blockedOverlay, speedMode, PathWorld::SearchMode::Forward);
+        checkCost(blockedOverlay, speedMode, PathWorld::SearchMode::Bidirectional);
+    }
+
+    // Region is slower and some nodes are flooded: snapshot taken before is unchanged
+    const BoostPoint& center = graph.getCentroid(goal);
+    path.scaleRegion(BoostBox(BoostPoint(center.get<0>() - 200.0f, center.get<1>() - 200.0f), BoostPoint(center.get<0>() + 200.0f, center.get<1>() + 200.0f)), 0.5f);
+    std::vector<std::pair<PathWorld::WalkTerrainID, Type>> terrains;
+    for(PathWorld::WalkTerrainID node = 0; node < graph.getNbNodes(); node += 5)
+    {
+        if(graph.getType(node) != Ocean)
+        {
+            terrains.emplace_back(node, Swamp);
+        }
+    }
+    ASSERT_NO_THROW(path.setTerrainOverride(terrains));
+    const std::shared_ptr<const CostOverlay> overlay = path.getOverlay();
+    EXPECT_EQ(3u, overlay->getVersion());
+    EXPECT_GE(0.5f, overlay->getMinFactor());
+    EXPECT_EQ(Swamp, overlay->getType(terrains.front().first, graph.getType(terrains.front().first)));
+    EXPECT_EQ(1.0f, blockedOverlay->getMinFactor());
+    for(const bool speedMode : { false, true })
+    {
+        checkCost(overlay, speedMode, PathWorld::SearchMode::Forward);
+        checkCost(overlay, speedMode, PathWorld::SearchMode::Bidirectional);
+    }
+
+    // Opened node: back to map costs
+    ASSERT_NO_THROW(path.clearOverrides());
+    EXPECT_EQ(4u, path.getOverlay()->getVersion());
+    checkCost(empty, false, PathWorld::SearchMode::Bidirectional);
+    pathWay.clear();
+    ASSERT_TRUE(path.computePath(newAgent, start, goal, pathWay, context));
+    ASSERT_EQ(original.size(), pathWay.size());
+
+    // Region into corner of envelope but outside polygon: only nodes under region are scaled
+    BoostBox corner;
+    PathWorld::WalkTerrainID outside = 0;
+    for(PathWorld::WalkTerrainID node = 0; node < graph.getNbNodes(); ++node)
+    {
+        BoostBox envelope;
+        bg::envelope(path.getWalkTerrain(node)._polygon, envelope);
+        const float size = 0.01f * std::min(envelope.max_corner().get<0>() - envelope.min_corner().get<0>(), envelope.max_corner().get<1>() - envelope.min_corner().get<1>());
+        corner = BoostBox(envelope.min_corner(), BoostPoint(envelope.min_corner().get<0>() + size, envelope.min_corner().get<1>() + size));
+        if(!bg::intersects(path.getWalkTerrain(node)._polygon, corner))
+        {
+            outside = node;
+            break;
+        }
+    }
+    ASSERT_FALSE(bg::intersects(path.getWalkTerrain(outside)._polygon, corner));
+
+    ASSERT_NO_THROW(path.scaleRegion(corner, 0.5f));
+    const std::shared_ptr<const CostOverlay> cornerOverlay = path.getOverlay();
+    for(PathWorld::WalkTerrainID node = 0; node < graph.getNbNodes(); ++node)
+    {
+        const bool isInside = bg::intersects(path.getWalkTerrain(node)._polygon, corner);
+        for(TerrainGraph::EdgeID edge = graph.beginEdge(node); edge != graph.endEdge(node); ++edge)
+        {
+            const bool isScaled = isInside || bg::intersects(path.getWalkTerrain(graph.getTarget(edge))._polygon, corner);
+            EXPECT_EQ(isScaled ? 0.5f : 1.0f, cornerOverlay->getFactor(edge));
+        }
+    }
+
+    ASSERT_NO_THROW(path.release());
+    EXPECT_EQ(nullptr, path.getOverlay());
+}
+
+TEST_F(PathWorldTest, COMPLEX_costOverlayStructures)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+    const PathWorld::WalkTerrainID start = 1050;
+    const PathWorld::WalkTerrainID goal  = 2450;
+    PathSearchContext context;
+
+    // Block all edges around middle node of route
+    ASSERT_TRUE(path.searchPath(newAgent, start, goal, context)._found);
+    std::vector<PathWorld::WalkTerrainID> route(1, goal);
+    while(route.back() != start)
+    {
+        route.push_back(context.getPredecessor(route.back()));
+    }
+    ASSERT_LT(2u, route.size());
+    const PathWorld::WalkTerrainID blocked = route[route.size() / 2];
+    std::vector<TerrainGraph::EdgeID> edges;
+    for(TerrainGraph::EdgeID edge = graph.beginEdge(blocked); edge != graph.endEdge(blocked); ++edge)
+    {
+        edges.push_back(edge);
+        edges.push_back(graph.getReverseEdge(edge));
+    }
+    ASSERT_NO_THROW(path.blockEdges(edges));
+
+    const PathWorld::SearchResult reference = path.searchPath(newAgent, start, goal, context, false, PathWorld::SearchMode::Bidirectional);
+    ASSERT_TRUE(reference._found);
+    const auto checkRoute = [&](const PathWorld::SearchResult& result, const std::vector<BoostPoint>& pathWay, const bool isOptimal)
+    {
+        ASSERT_TRUE(result._found);
+        if(isOptimal)
+        {
+            EXPECT_NEAR(reference._cost, result._cost, 1e-3f * reference._cost);
+        }
+        EXPECT_LE(reference._cost * 0.999f, result._cost);
+        ASSERT_FALSE(pathWay.empty());
+        for(const BoostPoint& point : pathWay)
+        {
+            EXPECT_FALSE(bg::equals(graph.getCentroid(blocked), point));
+        }
+    };
+
+    // Structures built after change read it
+    std::vector<BoostPoint> pathWay;
+    WeightProfile profile;
+    ASSERT_NO_THROW(profile.build(path, newAgent.getNavigation()));
+    EXPECT_TRUE(profile.isUpToDate());
+    for(const auto mode : { PathWorld::SearchMode::Forward, PathWorld::SearchMode::Bidirectional })
+    {
+        const PathWorld::SearchResult result = path.searchPath(profile, start, goal, context, mode);
+        pathWay.clear();
+        ASSERT_TRUE(result._found);
+        path.extractPath(goal, context, pathWay);
+        checkRoute(result, pathWay, mode == PathWorld::SearchMode::Bidirectional);
+    }
+
+    PathReplanner replanner;
+    ASSERT_NO_THROW(replanner.initialize(profile, start, goal));
+    pathWay.clear();
+    checkRoute(replanner.computePath(pathWay), pathWay, true);
+    ASSERT_NO_THROW(replanner.release());
+
+    ContractionHierarchy hierarchy;
+    ASSERT_NO_THROW(hierarchy.build(path, newAgent.getNavigation()));
+    EXPECT_TRUE(hierarchy.isUpToDate());
+    pathWay.clear();
+    checkRoute(hierarchy.computePath(start, goal, pathWay, context), pathWay, true);
+
+    ClusterGraph clusters;
+    ASSERT_NO_THROW(clusters.build(path, newAgent.getNavigation(), 64));
+    EXPECT_TRUE(clusters.isUpToDate());
+    pathWay.clear();
+    checkRoute(clusters.computePath(start, goal, pathWay, context), pathWay, false);
+
+    // Next change: all of them must be rebuilt
+    ASSERT_NO_THROW(path.clearOverrides());
+    EXPECT_FALSE(profile.isUpToDate());
+    EXPECT_FALSE(hierarchy.isUpToDate());
+    EXPECT_FALSE(clusters.isUpToDate());
+    ASSERT_NO_THROW(profile.release());
+    ASSERT_NO_THROW(hierarchy.release());
+    ASSERT_NO_THROW(clusters.release());
+
+    // Landmarks keep map weights: ALT stays optimal with faster region then faster terrain
+    Landmarks landmarks;
+    ASSERT_NO_THROW(landmarks.build(path, newAgent.getNavigation(), 8));
+    BoostBox region;
+    bg::assign_inverse(region);
+    for(const PathWorld::WalkTerrainID node : route)
+    {
+        bg::expand(region, graph.getCentroid(node));
+    }
+    ASSERT_NO_THROW(path.scaleRegion(region, 0.05f));
+
+    const auto checkLandmarks = [&]()
+    {
+        size_t nbValid = 0;
+        for(PathWorld::WalkTerrainID n1 = 0; n1 < graph.getNbNodes(); n1 += 11)
+        {
+            const PathWorld::SearchResult exact = path.searchPath(newAgent, start, n1, context, false, PathWorld::SearchMode::Bidirectional);
+            const PathWorld::SearchResult alt   = path.searchPath(newAgent, landmarks, start, n1, context);
+            ASSERT_EQ(exact._found, alt._found);
+            if(!exact._found)
+                continue;
+            ++nbValid;
+            EXPECT_NEAR(exact._cost, alt._cost, 1e-3f * std::max(1.0f, exact._cost));
+        }
+        EXPECT_LT(0u, nbValid);
+    };
+    checkLandmarks();
+
+    std::vector<std::pair<PathWorld::WalkTerrainID, Type>> terrains;
+    for(PathWorld::WalkTerrainID node = 0; node < graph.getNbNodes(); node += 3)
+    {
+        if(graph.getType(node) != Ocean)
+        {
+            terrains.emplace_back(node, Swamp);
+        }
+    }
+    ASSERT_NO_THROW(path.setTerrainOverride(terrains));
+    checkLandmarks();
+
+    ASSERT_NO_THROW(landmarks.release());
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_computeCosts)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+    const PathWorld::WalkTerrainID start = 1050;
+
+    // Candidates: same sub-graph, other sub-graph and duplicate
+    std::vector<PathWorld::WalkTerrainID> targets;
+    PathWorld::WalkTerrainID otherSubgraph = graph.getNbNodes();
+    for(PathWorld::WalkTerrainID node = 0; node < graph.getNbNodes(); node += 17)
+    {
+        if(graph.getSubgraphID(node) == graph.getSubgraphID(start))
+        {
+            targets.push_back(node);
+        }
+        else if(graph.getSubgraphID(node) != 0 && otherSubgraph == graph.getNbNodes())
+        {
+            otherSubgraph = node;
+        }
+    }
+    targets.push_back(targets.front());
+
+    for(const bool speedMode : { false, true })
+    {
+        std::vector<float> reference;
+        computeCosts(path, newAgent, start, reference, speedMode);
+
+        // One sweep: same costs as full Dijkstra
+        PathSearchContext context;
+        std::vector<PathWorld::CostType> costs;
+        std::vector<std::vector<BoostPoint>> pathWays;
+        auto begin = std::chrono::steady_clock::now();
+        const PathWorld::SearchResult result = path.computeCosts(newAgent, start, targets, costs, context, speedMode, &pathWays);
+        const auto durationSweep = std::chrono::steady_clock::now() - begin;
+        ASSERT_TRUE(result._found);
+        ASSERT_EQ(targets.size(), costs.size());
+        ASSERT_EQ(targets.size(), pathWays.size());
+        for(size_t targetID = 0; targetID < targets.size(); ++targetID)
+        {
+            EXPECT_NEAR(reference[targets[targetID]], costs[targetID], 1e-3f * reference[targets[targetID]]);
+            EXPECT_LE(costs[targetID], result._cost);
+            ASSERT_FALSE(pathWays[targetID].empty());
+            EXPECT_TRUE(bg::equals(graph.getCentroid(targets[targetID]), pathWays[targetID].front()));
+            EXPECT_TRUE(bg::equals(graph.getCentroid(start), pathWays[targetID].back()));
+        }
+
+        // Closest target only: sweep stops early
+        const auto nearest = std::min_element(costs.begin(), costs.end());
+        std::vector<PathWorld::CostType> nearestCost;
+        const PathWorld::SearchResult partial = path.computeCosts(newAgent, start, { targets[nearest - costs.begin()] }, nearestCost, context, speedMode);
+        ASSERT_TRUE(partial._found);
+        EXPECT_EQ(*nearest, nearestCost.front());
+        EXPECT_GT(result._nbExpansions, partial._nbExpansions);
+
+        // Same answers with one search by target
+        begin = std::chrono::steady_clock::now();
+        for(const PathWorld::WalkTerrainID to : targets)
+        {
+            ASSERT_TRUE(path.searchPath(newAgent, start, to, context, speedMode)._found);
+        }
+        const auto durationSearches = std::chrono::steady_clock::now() - begin;
+        std::cout << std::endl << (speedMode ? "Speed mode" : "Agent weight") << " one-to-many (" << targets.size() << " targets):" << std::endl;
+        std::cout << "  One sweep:       " << std::chrono::duration_cast<std::chrono::microseconds>(durationSweep).count() << " us" << std::endl;
+        std::cout << "  One search each: " << std::chrono::duration_cast<std::chrono::microseconds>(durationSearches).count() << " us" << std::endl;
+    }
+
+    // Other sub-graph is rejected without search
+    if(otherSubgraph != graph.getNbNodes())
+    {
+        PathSearchContext context;
+        std::vector<PathWorld::CostType> costs;
+        const PathWorld::SearchResult result = path.computeCosts(newAgent, start, { otherSubgraph }, costs, context);
+        EXPECT_FALSE(result._found);
+        EXPECT_EQ(0u, result._nbExpansions);
+        EXPECT_EQ(std::numeric_limits<PathWorld::CostType>::infinity(), costs.front());
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_costMatrix)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+
+    ContractionHierarchy hierarchy;
+    ASSERT_NO_THROW(hierarchy.build(path, newAgent.getNavigation()));
+
+    // Depots and destinations spread on whole map (some in other sub-graph)
+    const size_t nbItems = 1000;
+    std::vector<PathWorld::WalkTerrainID> sources;
+    std::vector<PathWorld::WalkTerrainID> targets;
+    for(size_t itemID = 0; itemID < nbItems; ++itemID)
+    {
+        sources.push_back(static_cast<PathWorld::WalkTerrainID>(itemID * graph.getNbNodes() / nbItems));
+        targets.push_back(static_cast<PathWorld::WalkTerrainID>((itemID * graph.getNbNodes() / nbItems + 3) % graph.getNbNodes()));
+    }
+
+    BT::ThreadPool pool(4);
+    std::vector<PathWorld::CostType> matrix;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_NO_THROW(path.computeCostMatrix(hierarchy, sources, targets, matrix, pool));
+    std::cout << std::endl << "Cost matrix " << nbItems << "x" << nbItems << ":" << std::endl;
+    std::cout << "  Buckets on hierarchy: " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+    ASSERT_EQ(nbItems * nbItems, matrix.size());
+
+    // Reference: one sweep by row (only some rows)
+    const std::vector<PathWorld::WalkTerrainID> someSources(sources.begin(), sources.begin() + 100);
+    std::vector<PathWorld::CostType> reference;
+    start = std::chrono::steady_clock::now();
+    ASSERT_NO_THROW(path.computeCostMatrix(newAgent, someSources, targets, reference, pool));
+    std::cout << "  One sweep by row:     " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms for " << someSources.size() << " rows" << std::endl;
+    ASSERT_EQ(someSources.size() * nbItems, reference.size());
+
+    size_t nbValid = 0;
+    for(size_t cellID = 0; cellID < reference.size(); ++cellID)
+    {
+        ASSERT_EQ(reference[cellID] != std::numeric_limits<float>::infinity(), matrix[cellID] != std::numeric_limits<float>::infinity());
+        if(reference[cellID] != std::numeric_limits<float>::infinity())
+        {
+            ++nbValid;
+            EXPECT_NEAR(reference[cellID], matrix[cellID], 1e-3f * std::max(1.0f, reference[cellID]));
+        }
+    }
+    EXPECT_LT(0u, nbValid);
+
+    // Same as point to point query
+    PathSearchContext context;
+    for(size_t sourceID = 0; sourceID < nbItems; sourceID += 97)
+    {
+        for(size_t targetID = 0; targetID < nbItems; targetID += 89)
+        {
+            std::vector<BoostPoint> pathWay;
+            const PathWorld::SearchResult result = hierarchy.computePath(sources[sourceID], targets[targetID], pathWay, context);
+            const PathWorld::CostType cost = matrix[sourceID * nbItems + targetID];
+            ASSERT_EQ(result._found, cost != std::numeric_limits<float>::infinity());
+            if(result._found)
+            {
+                EXPECT_NEAR(result._cost, cost, 1e-3f * std::max(1.0f, cost));
+            }
+        }
+    }
+
+    ASSERT_NO_THROW(hierarchy.release());
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_isochrone)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const PathWorld::WalkTerrainID start = 1050;
+
+    std::vector<float> costs;
+    computeCosts(path, newAgent, start, costs);
+
+    // Budget: half of farthest reachable node
+    float maxCost = 0.0f;
+    for(const float cost : costs)
+    {
+        if(cost != std::numeric_limits<float>::infinity())
+            maxCost = std::max(maxCost, cost);
+    }
+    const float budget = maxCost * 0.5f;
+
+    PathSearchContext context;
+    std::vector<PathWorld::ReachedNode> reached;
+    BoostMultiPolygon region;
+    PathWorld::SearchResult result = path.computeIsochrone(newAgent, start, budget, reached, context, false, &region);
+    EXPECT_TRUE(result._found);
+    EXPECT_GE(budget, result._cost);
+
+    // Same nodes as full Dijkstra, sorted by cost
+    const size_t nbReference = std::count_if(costs.begin(), costs.end(), [&](float cost) { return cost <= budget; });
+    ASSERT_EQ(nbReference, reached.size());
+    EXPECT_EQ(start, reached.front()._node);
+    for(size_t nodeID = 0; nodeID < reached.size(); ++nodeID)
+    {
+        EXPECT_NEAR(costs[reached[nodeID]._node], reached[nodeID]._cost, 1e-3f * std::max(1.0f, reached[nodeID]._cost));
+        if(nodeID > 0)
+        {
+            EXPECT_LE(reached[nodeID - 1]._cost, reached[nodeID]._cost);
+        }
+    }
+
+    // Region covers polygons (map polygons may overlap a bit)
+    double sumArea = 0.0;
+    double outsideArea = 0.0;
+    for(const PathWorld::ReachedNode& node : reached)
+    {
+        const BoostPolygon& polygon = path.getWalkTerrain(node._node)._polygon;
+        sumArea += bg::area(polygon);
+
+        BoostMultiPolygon outside;
+        bg::difference(polygon, region, outside);
+        outsideArea += bg::area(outside);
+    }
+    EXPECT_FALSE(region.empty());
+    EXPECT_TRUE(bg::is_valid(region));
+    EXPECT_GE(1e-3 * sumArea, outsideArea);
+    EXPECT_GE(sumArea * 1.001, bg::area(region));
+    EXPECT_LE(sumArea * 0.95, bg::area(region));
+
+    // Moving agent: workspace is reused
+    const PathWorld::ReachedNode* storage = reached.data();
+    const auto begin = std::chrono::steady_clock::now();
+    for(size_t nodeID = 0; nodeID < reached.size(); nodeID += reached.size() / 20)
+    {
+        result = path.computeIsochrone(newAgent, reached[nodeID]._node, budget * 0.25f, reached, context);
+        EXPECT_EQ(storage, reached.data());
+    }
+    std::cout << std::endl << "Isochrones: " << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() << " us for 20 queries" << std::endl;
+
+    // Whole sub-graph inside budget
+    result = path.computeIsochrone(newAgent, start, maxCost, reached, context);
+    EXPECT_FALSE(result._found);
+    EXPECT_EQ(static_cast<size_t>(std::count_if(costs.begin(), costs.end(), [](float cost) { return cost != std::numeric_limits<float>::infinity(); })), reached.size());
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_smoothPath)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+
+    const auto getLength = [](const std::vector<BoostPoint>& pathWay)
+    {
+        double length = 0.0;
+        for(size_t pointID = 1; pointID < pathWay.size(); ++pointID)
+        {
+            length += bg::distance(pathWay[pointID - 1], pathWay[pointID]);
+        }
+        return length;
+    };
+
+    PathSearchContext context;
+    std::vector<BoostPoint> centroids;
+    std::vector<BoostPoint> corners;
+    corners.reserve(graph.getNbNodes());
+    const BoostPoint* storage = corners.data();
+    size_t nbCentroids = 0;
+    size_t nbCorners = 0;
+    std::chrono::nanoseconds duration(0);
+    for(const PathWorld::WalkTerrainID n0 : { 1050u, 3251u, 550u })
+    {
+        for(PathWorld::WalkTerrainID n1 = 0; n1 < graph.getNbNodes(); n1 += 97)
+        {
+            centroids.clear();
+            if(!path.computePath(newAgent, n0, n1, centroids, context))
+                continue;
+
+            corners.clear();
+            const auto start = std::chrono::steady_clock::now();
+            path.smoothPath(n1, context, corners);
+            duration += std::chrono::steady_clock::now() - start;
+            EXPECT_EQ(storage, corners.data());
+
+            // Same extremities, fewer points and shorter
+            ASSERT_FALSE(corners.empty());
+            EXPECT_TRUE(bg::equals(centroids.front(), corners.front()));
+            EXPECT_TRUE(bg::equals(centroids.back(), corners.back()));
+            EXPECT_GE(centroids.size(), corners.size());
+            EXPECT_GE(getLength(centroids) * (1.0 + 1e-5), getLength(corners));
+            nbCentroids += centroids.size();
+            nbCorners   += corners.size();
+
+            // Corners stay inside polygons of route
+            for(size_t pointID = 1; pointID < corners.size(); ++pointID)
+            {
+                for(const double ratio : { 0.25, 0.5, 0.75 })
+                {
+                    BoostPoint point;
+                    point.set<0>(static_cast<float>(corners[pointID - 1].get<0>() * (1.0 - ratio) + corners[pointID].get<0>() * ratio));
+                    point.set<1>(static_cast<float>(corners[pointID - 1].get<1>() * (1.0 - ratio) + corners[pointID].get<1>() * ratio));
+                    bool isInside = false;
+                    for(PathWorld::WalkTerrainID node = n1; !isInside; node = context.getPredecessor(node))
+                    {
+                        isInside = bg::distance(point, path.getWalkTerrain(node)._polygon) < 1e-1;
+                        if(context.getPredecessor(node) == node)
+                            break;
+                    }
+                    EXPECT_TRUE(isInside);
+                }
+            }
+
+            std::vector<BoostPoint> smooth;
+            ASSERT_TRUE(path.computeSmoothPath(newAgent, n0, n1, smooth, context));
+            EXPECT_EQ(corners.size(), smooth.size());
+        }
+    }
+    ASSERT_LT(0u, nbCorners);
+    std::cout << std::endl << "Smooth path: " << nbCentroids << " centroids -> " << nbCorners << " corners in " << std::chrono::duration_cast<std::chrono::microseconds>(duration).count() << " us" << std::endl;
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_computePathFromPoints)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    Agent newAgent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const TerrainGraph& graph = path.getGraph();
+
+    // Point inside polygon: same node as findNearest
+    const auto getInside = [&](PathWorld::WalkTerrainID node)
+    {
+        const BoostPolygon& polygon = path.getWalkTerrain(node)._polygon;
+        BoostPoint point;
+        bg::set<0>(point, (polygon.outer()[0].get<0>() + polygon.outer()[1].get<0>() + polygon.outer()[2].get<0>()) / 3.0f);
+        bg::set<1>(point, (polygon.outer()[0].get<1>() + polygon.outer()[1].get<1>() + polygon.outer()[2].get<1>()) / 3.0f);
+        return point;
+    };
+    size_t nbLocated = 0;
+    for(PathWorld::WalkTerrainID node = 0; node < graph.getNbNodes(); node += 13)
+    {
+        const BoostPoint point = getInside(node);
+        PathWorld::WalkTerrainID located = 0;
+        if(path.locate(point, located))
+        {
+            ++nbLocated;
+            EXPECT_EQ(path.findNearest(point).second, located);
+            EXPECT_TRUE(bg::within(point, path.getWalkTerrain(located)._polygon));
+        }
+        else
+        {
+            EXPECT_ANY_THROW(path.findNearest(point));
+        }
+    }
+    EXPECT_LT(0u, nbLocated);
+
+    // Exact points as extremities, same route between
+    PathSearchContext context;
+    const BoostPoint from = getInside(1050);
+    for(const PathWorld::WalkTerrainID goal : { 1500u, 1000u, 3251u, 1050u })
+    {
+        const BoostPoint to = getInside(goal);
+        PathWorld::WalkTerrainID start = 0;
+        PathWorld::WalkTerrainID end   = 0;
+        ASSERT_TRUE(path.locate(from, start));
+        ASSERT_TRUE(path.locate(to, end));
+
+        std::vector<BoostPoint> reference;
+        const bool isValid = path.computePath(newAgent, start, end, reference, context);
+        std::vector<BoostPoint> pathWay;
+        ASSERT_EQ(isValid, path.computePath(newAgent, from, to, pathWay, context));
+        if(!isValid)
+            continue;
+
+        ASSERT_EQ(std::max<size_t>(2, reference.size()), pathWay.size());
+        EXPECT_TRUE(bg::equals(to, pathWay.front()));
+        EXPECT_TRUE(bg::equals(from, pathWay.back()));
+        for(size_t pointID = 1; pointID + 1 < reference.size(); ++pointID)
+        {
+            EXPECT_TRUE(bg::equals(reference[pointID], pathWay[pointID]));
+        }
+    }
+
+    // Outside world or other sub-graph: no search
+    BoostPoint outside;
+    bg::set<0>(outside, 1e7f);
+    bg::set<1>(outside, 1e7f);
+    std::vector<BoostPoint> pathWay;
+    EXPECT_FALSE(path.computePath(newAgent, from, outside, pathWay, context));
+    EXPECT_TRUE(pathWay.empty());
+    EXPECT_FALSE(path.computePath(newAgent, from, getInside(3067), pathWay, context));
+    EXPECT_TRUE(pathWay.empty());
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_locateBatch)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    const TerrainGraph& graph = path.getGraph();
+    BoostBox bounds;
+    bg::envelope(path.getWalkTerrain(0)._polygon, bounds);
+    for(PathWorld::WalkTerrainID node = 1; node < graph.getNbNodes(); ++node)
+    {
+        bg::expand(bounds, graph.getCentroid(node));
+    }
+
+    // Agents spread on whole map (some outside polygons)
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> randomX(bounds.min_corner().get<0>(), bounds.max_corner().get<0>());
+    std::uniform_real_distribution<float> randomY(bounds.min_corner().get<1>(), bounds.max_corner().get<1>());
+    std::vector<BoostPoint> positions(20000);
+    for(BoostPoint& position : positions)
+    {
+        position = BoostPoint(randomX(generator), randomY(generator));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PathWorld::WalkTerrainID> references(positions.size(), PathWorld::_noNode);
+    for(size_t pointID = 0; pointID < positions.size(); ++pointID)
+    {
+        path.locate(positions[pointID], references[pointID]);
+    }
+    const auto durationSingle = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<PathWorld::WalkTerrainID> nodes;
+    path.locate(positions, nodes);
+    const auto durationBatch = std::chrono::steady_clock::now() - start;
+
+    BT::ThreadPool pool(4);
+    start = std::chrono::steady_clock::now();
+    std::vector<PathWorld::WalkTerrainID> parallelNodes;
+    path.locate(positions, parallelNodes, &pool);
+    const auto durationParallel = std::chrono::steady_clock::now() - start;
+
+    std::cout << std::endl << "Locate " << positions.size() << " points:" << std::endl;
+    std::cout << "  One by one: " << std::chrono::duration_cast<std::chrono::microseconds>(durationSingle).count() << " us" << std::endl;
+    std::cout << "  Batch:      " << std::chrono::duration_cast<std::chrono::microseconds>(durationBatch).count() << " us" << std::endl;
+    std::cout << "  Parallel:   " << std::chrono::duration_cast<std::chrono::microseconds>(durationParallel).count() << " us" << std::endl;
+
+    // Same answer (overlapping polygons may give other node containing point)
+    ASSERT_EQ(positions.size(), nodes.size());
+    EXPECT_TRUE(nodes == parallelNodes);
+    size_t nbFound = 0;
+    size_t nbSame = 0;
+    for(size_t pointID = 0; pointID < positions.size(); ++pointID)
+    {
+        if(references[pointID] == PathWorld::_noNode)
+        {
+            EXPECT_EQ(PathWorld::_noNode, nodes[pointID]);
+            continue;
+        }
+        ++nbFound;
+        ASSERT_NE(PathWorld::_noNode, nodes[pointID]);
+        nbSame += references[pointID] == nodes[pointID] ? 1 : 0;
+        EXPECT_TRUE(bg::covered_by(positions[pointID], path.getWalkTerrain(nodes[pointID])._polygon));
+    }
+    EXPECT_LT(0u, nbFound);
+    EXPECT_LE(nbFound * 0.99, nbSame);
+
+    ASSERT_NO_THROW(path.release());
+}
+
+/// Allocator counting bytes of R*-tree nodes (memory of benchmark).
+template<typename DataType>
+struct CountingAllocator : std::allocator<DataType>
+{
+    template<typename OtherType>
+    struct rebind
+    {
+        using other = CountingAllocator<OtherType>;
+    };
+
+    CountingAllocator(size_t& allocated):
+    _allocated(&allocated)
+    {}
+
+    template<typename OtherType>
+    CountingAllocator(const CountingAllocator<OtherType>& other):
+    _allocated(other._allocated)
+    {}
+
+    DataType* allocate(size_t nbItems)
+    {
+        *_allocated += nbItems * sizeof(DataType);
+        return std::allocator<DataType>::allocate(nbItems);
+    }
+
+    void deallocate(DataType* data, size_t nbItems)
+    {
+        *_allocated -= nbItems * sizeof(DataType);
+        std::allocator<DataType>::deallocate(data, nbItems);
+    }
+
+    size_t* _allocated;
+};
+
+TEST_F(PathWorldTest, COMPLEX_spatialIndex)
+{
+    const std::array<BT::StringOS, 3> maps = { L"map/Map_easy.map", L"map/Map_small.map", L"map/Map_complex.map" };
+    const std::array<PathWorld::IndexType, 3> indexes = { PathWorld::IndexType::RTree, PathWorld::IndexType::UniformGrid, PathWorld::IndexType::MultiLevelGrid };
+    const std::array<const char*, 3> names = { "R*-tree:   ", "Uniform:   ", "MultiLevel:" };
+
+    for(const BT::StringOS& map : maps)
+    {
+        std::vector<BoostPoint> positions(20000);
+        std::vector<PathWorld::WalkTerrainID> references;
+        std::cout << std::endl << "Locate " << positions.size() << " points on " << BT::convertToU8(map) << ":" << std::endl;
+
+        for(size_t indexID = 0; indexID < indexes.size(); ++indexID)
+        {
+            PathWorld path;
+            read(map, path, indexes[indexID]);
+            ASSERT_EQ(indexes[indexID], path.getIndexType());
+            ASSERT_EQ(indexes[indexID] == PathWorld::IndexType::RTree, path.getGridIndex().isNull());
+
+            size_t memory = path.getGridIndex().getMemorySize();
+            if(indexID == 0)
+            {
+                // Same points for all index
+                const TerrainGraph& graph = path.getGraph();
+                BoostBox bounds;
+                bg::envelope(path.getWalkTerrain(0)._polygon, bounds);
+                for(PathWorld::WalkTerrainID node = 1; node < graph.getNbNodes(); ++node)
+                {
+                    bg::expand(bounds, graph.getCentroid(node));
+                }
+                std::mt19937 generator(42);
+                std::uniform_real_distribution<float> randomX(bounds.min_corner().get<0>(), bounds.max_corner().get<0>());
+                std::uniform_real_distribution<float> randomY(bounds.min_corner().get<1>(), bounds.max_corner().get<1>());
+                for(BoostPoint& position : positions)
+                {
+                    position = BoostPoint(randomX(generator), randomY(generator));
+                }
+
+                // Same R*-tree with counting allocator
+                size_t allocated = 0;
+                {
+                    using CountedTree = bgi::rtree<PathWorld::AreaBox, bgi::rstar<16>, bgi::indexable<PathWorld::AreaBox>, bgi::equal_to<PathWorld::AreaBox>, CountingAllocator<PathWorld::AreaBox>>;
+                    std::vector<PathWorld::AreaBox> areas;
+                    for(PathWorld::WalkTerrainID node = 0; node < graph.getNbNodes(); ++node)
+                    {
+                        BoostBox box;
+                        bg::envelope(path.getWalkTerrain(node)._polygon, box);
+                        areas.emplace_back(box, node);
+                    }
+                    CountedTree tree(areas, bgi::rstar<16>{}, bgi::indexable<PathWorld::AreaBox>{}, bgi::equal_to<PathWorld::AreaBox>{}, CountingAllocator<PathWorld::AreaBox>(allocated));
+                    memory = allocated;
+                }
+                EXPECT_EQ(0u, allocated);
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<PathWorld::WalkTerrainID> nodes(positions.size(), PathWorld::_noNode);
+            for(size_t pointID = 0; pointID < positions.size(); ++pointID)
+            {
+                path.locate(positions[pointID], nodes[pointID]);
+            }
+            const auto duration = std::chrono::steady_clock::now() - start;
+
+            std::cout << "  " << names[indexID] << " " << std::chrono::duration_cast<std::chrono::microseconds>(duration).count() << " us, "
+                      << memory / 1024 << " KB";
+            if(!path.getGridIndex().isNull())
+            {
+                std::cout << " (" << path.getGridIndex().getNbLevels() << " levels)";
+            }
+            std::cout << std::endl;
+
+            // Same point found (overlapping polygons may give other node containing point)
+            if(indexID == 0)
+            {
+                references = nodes;
+            }
+            else
+            {
+                std::vector<PathWorld::WalkTerrainID> batchNodes;
+                path.locate(positions, batchNodes);
+                EXPECT_TRUE(nodes == batchNodes);
+                for(size_t pointID = 0; pointID < positions.size(); ++pointID)
+                {
+                    ASSERT_EQ(references[pointID] == PathWorld::_noNode, nodes[pointID] == PathWorld::_noNode);
+                    if(nodes[pointID] != PathWorld::_noNode)
+                    {
+                        EXPECT_TRUE(bg::covered_by(positions[pointID], path.getWalkTerrain(nodes[pointID])._polygon));
+                    }
+                }
+            }
+
+            ASSERT_NO_THROW(path.release());
+        }
+    }
+}
+
+TEST_F(PathWorldTest, COMPLEX_rtreeBulkLoad)
+{
+    const std::array<BT::StringOS, 3> maps = { L"map/Map_easy.map", L"map/Map_small.map", L"map/Map_complex.map" };
+    for(const BT::StringOS& map : maps)
+    {
+        PathWorld path;
+        read(map, path);
+
+        std::vector<PathWorld::AreaBox> areas;
+        BoostBox bounds;
+        bg::envelope(path.getWalkTerrain(0)._polygon, bounds);
+        for(PathWorld::WalkTerrainID node = 0; node < path.getGraph().getNbNodes(); ++node)
+        {
+            BoostBox box;
+            bg::envelope(path.getWalkTerrain(node)._polygon, box);
+            bg::expand(bounds, box);
+            areas.emplace_back(box, node);
+        }
+
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> randomX(bounds.min_corner().get<0>(), bounds.max_corner().get<0>());
+        std::uniform_real_distribution<float> randomY(bounds.min_corner().get<1>(), bounds.max_corner().get<1>());
+        std::vector<BoostPoint> positions(20000);
+        for(BoostPoint& position : positions)
+        {
+            position = BoostPoint(randomX(generator), randomY(generator));
+        }
+
+        // Build both trees
+        auto start = std::chrono::steady_clock::now();
+        PathWorld::QuadTree inserted;
+        for(const PathWorld::AreaBox& area : areas)
+        {
+            inserted.insert(area);
+        }
+        const auto durationInsert = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        PathWorld::QuadTree packed(areas);
+        const auto durationPacked = std::chrono::steady_clock::now() - start;
+
+        ASSERT_EQ(inserted.size(), packed.size());
+
+        // Query both trees: same boxes must be found
+        const auto query = [&](const PathWorld::QuadTree& tree, std::vector<size_t>& nbFounds)
+        {
+            nbFounds.clear();
+            std::vector<PathWorld::AreaBox> founds;
+            const auto startQuery = std::chrono::steady_clock::now();
+            for(const BoostPoint& position : positions)
+            {
+                founds.clear();
+                tree.query(bgi::intersects(position), std::back_inserter(founds));
+                nbFounds.push_back(founds.size());
+            }
+            return std::chrono::steady_clock::now() - startQuery;
+        };
+        std::vector<size_t> nbInserted;
+        std::vector<size_t> nbPacked;
+        const auto queryInsert = query(inserted, nbInserted);
+        const auto queryPacked = query(packed, nbPacked);
+        EXPECT_TRUE(nbInserted == nbPacked);
+
+        std::cout << std::endl << "R*-tree of " << areas.size() << " boxes on " << BT::convertToU8(map) << ":" << std::endl;
+        std::cout << "  Insert: build " << std::chrono::duration_cast<std::chrono::microseconds>(durationInsert).count() << " us, query "
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(queryInsert).count() / positions.size() << " ns" << std::endl;
+        std::cout << "  Packed: build " << std::chrono::duration_cast<std::chrono::microseconds>(durationPacked).count() << " us, query "
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(queryPacked).count() / positions.size() << " ns" << std::endl;
+
+        ASSERT_NO_THROW(path.release());
+    }
+}
+
+TEST_F(PathWorldTest, COMPLEX_relocate)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    const TerrainGraph& graph = path.getGraph();
+    BoostBox bounds;
+    bg::envelope(path.getWalkTerrain(0)._polygon, bounds);
+    for(PathWorld::WalkTerrainID node = 1; node < graph.getNbNodes(); ++node)
+    {
+        bg::expand(bounds, graph.getCentroid(node));
+    }
+
+    // Agents start on centroid and walk straight: step is small against polygons
+    const size_t nbAgents = 2000;
+    const size_t nbUpdates = 20;
+    const float step = std::sqrt(bg::area(bounds) / static_cast<float>(graph.getNbNodes())) * 0.1f;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<PathWorld::WalkTerrainID> randomNode(0, static_cast<PathWorld::WalkTerrainID>(graph.getNbNodes() - 1));
+    std::uniform_real_distribution<float> randomAngle(0.0f, 6.2831853f);
+    std::vector<BoostPoint> positions(nbAgents);
+    std::vector<BoostPoint> directions(nbAgents);
+    for(size_t agentID = 0; agentID < nbAgents; ++agentID)
+    {
+        positions[agentID] = graph.getCentroid(randomNode(generator));
+        const float angle = randomAngle(generator);
+        directions[agentID] = BoostPoint(std::cos(angle) * step, std::sin(angle) * step);
+    }
+
+    std::vector<PathWorld::WalkTerrainID> singleNodes(nbAgents, PathWorld::_noNode);
+    std::vector<PathWorld::WalkTerrainID> batchNodes(nbAgents, PathWorld::_noNode);
+    PathWorld::RelocateStats singleStats;
+    PathWorld::RelocateStats batchStats;
+    std::chrono::steady_clock::duration durationLocate(0);
+    std::chrono::steady_clock::duration durationSingle(0);
+    std::chrono::steady_clock::duration durationBatch(0);
+    for(size_t update = 0; update < nbUpdates; ++update)
+    {
+        for(size_t agentID = 0; agentID < nbAgents; ++agentID)
+        {
+            bg::add_point(positions[agentID], directions[agentID]);
+        }
+
+        // Reference: from scratch
+        auto start = std::chrono::steady_clock::now();
+        std::vector<PathWorld::WalkTerrainID> references(nbAgents, PathWorld::_noNode);
+        for(size_t agentID = 0; agentID < nbAgents; ++agentID)
+        {
+            path.locate(positions[agentID], references[agentID]);
+        }
+        durationLocate += std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for(size_t agentID = 0; agentID < nbAgents; ++agentID)
+        {
+            PathWorld::WalkTerrainID node = PathWorld::_noNode;
+            path.relocate(singleNodes[agentID], positions[agentID], node, &singleStats);
+            singleNodes[agentID] = node;
+        }
+        durationSingle += std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        path.relocate(positions, batchNodes, &batchStats);
+        durationBatch += std::chrono::steady_clock::now() - start;
+
+        EXPECT_TRUE(singleNodes == batchNodes);
+        for(size_t agentID = 0; agentID < nbAgents; ++agentID)
+        {
+            EXPECT_EQ(references[agentID] == PathWorld::_noNode, singleNodes[agentID] == PathWorld::_noNode);
+            if(singleNodes[agentID] != PathWorld::_noNode)
+            {
+                EXPECT_TRUE(bg::covered_by(positions[agentID], path.getWalkTerrain(singleNodes[agentID])._polygon));
+            }
+        }
+    }
+
+    std::cout << std::endl << "Relocate " << nbAgents << " agents x " << nbUpdates << " updates:" << std::endl;
+    std::cout << "  Locate:   " << std::chrono::duration_cast<std::chrono::microseconds>(durationLocate).count() << " us" << std::endl;
+    std::cout << "  Relocate: " << std::chrono::duration_cast<std::chrono::microseconds>(durationSingle).count() << " us" << std::endl;
+    std::cout << "  Batch:    " << std::chrono::duration_cast<std::chrono::microseconds>(durationBatch).count() << " us" << std::endl;
+    std::cout << "  Same: " << singleStats._nbSame << " Neighbour: " << singleStats._nbNeighbour << " Index: " << singleStats._nbIndex
+              << " Outside: " << singleStats._nbOutside << " (hit rate " << singleStats.getHitRate() * 100.0f << "%)" << std::endl;
+
+    EXPECT_EQ(nbAgents * nbUpdates, singleStats.getNbQueries());
+    EXPECT_EQ(singleStats._nbSame, batchStats._nbSame);
+    EXPECT_EQ(singleStats._nbNeighbour, batchStats._nbNeighbour);
+    EXPECT_EQ(singleStats._nbIndex, batchStats._nbIndex);
+    EXPECT_EQ(singleStats._nbOutside, batchStats._nbOutside);
+    EXPECT_LT(0.8f, singleStats.getHitRate());
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_openList)
+{
+    const std::array<BT::StringOS, 3> maps = { L"map/Map_easy.map", L"map/Map_small.map", L"map/Map_complex.map" };
+    const std::array<PathSearchContext::OpenListType, 4> types = { PathSearchContext::OpenListType::BinaryHeap, PathSearchContext::OpenListType::QuaternaryHeap,
+                                                                   PathSearchContext::OpenListType::RadixHeap, PathSearchContext::OpenListType::Bucket };
+    const std::array<const char*, 4> names = { "Binary heap:", "4-ary heap: ", "Radix heap: ", "Bucket:     " };
+    const Agent agent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+
+    for(const BT::StringOS& map : maps)
+    {
+        PathWorld path;
+        read(map, path);
+        const TerrainGraph& graph = path.getGraph();
+        const PathWorld::WalkTerrainID nbNodes = static_cast<PathWorld::WalkTerrainID>(graph.getNbNodes());
+
+        // Same queries for all open lists
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<PathWorld::WalkTerrainID> randomNode(0, nbNodes - 1);
+        std::vector<std::pair<PathWorld::WalkTerrainID, PathWorld::WalkTerrainID>> queries;
+        while(queries.size() < 200)
+        {
+            const PathWorld::WalkTerrainID from = randomNode(generator);
+            const PathWorld::WalkTerrainID to   = randomNode(generator);
+            if(graph.getSubgraphID(from) == graph.getSubgraphID(to))
+            {
+                queries.emplace_back(from, to);
+            }
+        }
+        std::vector<PathWorld::WalkTerrainID> targets(nbNodes);
+        std::iota(targets.begin(), targets.end(), 0);
+        const std::vector<PathWorld::WalkTerrainID> sources = { queries[0].first, queries[1].first, queries[2].first, queries[3].first };
+
+        // Quantum: 1/4096 of longest cost from first source (A*: of squared distance used by heuristic)
+        PathSearchContext reference;
+        std::vector<PathWorld::CostType> referenceCosts;
+        path.computeCosts(agent, sources.front(), targets, referenceCosts, reference);
+        PathWorld::CostType maxCost = 0.0f;
+        for(const PathWorld::CostType cost : referenceCosts)
+        {
+            maxCost = std::isinf(cost) ? maxCost : std::max(maxCost, cost);
+        }
+        BoostBox bounds(graph.getCentroid(0), graph.getCentroid(0));
+        for(PathWorld::WalkTerrainID node = 1; node < nbNodes; ++node)
+        {
+            bg::expand(bounds, graph.getCentroid(node));
+        }
+        const PathWorld::CostType quantum      = std::max(maxCost / 4096.0f, 1e-6f);
+        const PathWorld::CostType quantumAStar = std::max(static_cast<PathWorld::CostType>(bg::comparable_distance(bounds.min_corner(), bounds.max_corner())) / 4096.0f, quantum);
+
+        std::cout << std::endl << "Open list on " << BT::convertToU8(map) << " (" << queries.size() << " A* / bidirectional, "
+                  << sources.size() << " Dijkstra on " << nbNodes << " nodes):" << std::endl;
+
+        std::vector<PathWorld::CostType> exactCosts;
+        std::vector<PathWorld::CostType> exactBidirectional;
+        for(size_t typeID = 0; typeID < types.size(); ++typeID)
+        {
+            PathSearchContext context;
+            context.setOpenList(types[typeID], quantumAStar);
+            EXPECT_EQ(types[typeID], context.getOpenListType());
+
+            // A* forward
+            auto start = std::chrono::steady_clock::now();
+            size_t nbFound = 0;
+            for(const auto& query : queries)
+            {
+                nbFound += path.searchPath(agent, query.first, query.second, context)._found ? 1 : 0;
+            }
+            const auto durationForward = std::chrono::steady_clock::now() - start;
+            EXPECT_EQ(queries.size(), nbFound);
+
+            // Bidirectional (optimal: cost is checked)
+            context.setOpenList(types[typeID], quantum);
+            start = std::chrono::steady_clock::now();
+            std::vector<PathWorld::CostType> bidirectional;
+            for(const auto& query : queries)
+            {
+                bidirectional.push_back(path.searchPath(agent, query.first, query.second, context, false, PathWorld::SearchMode::Bidirectional)._cost);
+            }
+            const auto durationBidirectional = std::chrono::steady_clock::now() - start;
+
+            // Dijkstra on whole graph
+            start = std::chrono::steady_clock::now();
+            std::vector<PathWorld::CostType> allCosts;
+            for(const PathWorld::WalkTerrainID source : sources)
+            {
+                std::vector<PathWorld::CostType> costs;
+                path.computeCosts(agent, source, targets, costs, context);
+                allCosts.insert(allCosts.end(), costs.begin(), costs.end());
+            }
+            const auto durationDijkstra = std::chrono::steady_clock::now() - start;
+
+            std::cout << "  " << names[typeID] << " A* " << std::chrono::duration_cast<std::chrono::microseconds>(durationForward).count() << " us, bidirectional "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(durationBidirectional).count() << " us, Dijkstra "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(durationDijkstra).count() << " us" << std::endl;
+
+            // Heaps are exact, quantized lists are exact up to few quantum
+            if(typeID == 0)
+            {
+                exactCosts = allCosts;
+                exactBidirectional = bidirectional;
+                continue;
+            }
+            const PathWorld::CostType tolerance = types[typeID] == PathSearchContext::OpenListType::QuaternaryHeap ? 1e-3f : quantum * 4.0f + 1e-3f;
+            ASSERT_EQ(exactCosts.size(), allCosts.size());
+            for(size_t costID = 0; costID < allCosts.size(); ++costID)
+            {
+                if(std::isinf(exactCosts[costID]))
+                {
+                    EXPECT_TRUE(std::isinf(allCosts[costID]));
+                    continue;
+                }
+                EXPECT_NEAR(exactCosts[costID], allCosts[costID], tolerance);
+            }
+            for(size_t queryID = 0; queryID < queries.size(); ++queryID)
+            {
+                EXPECT_NEAR(exactBidirectional[queryID], bidirectional[queryID], tolerance * 2.0f);
+            }
+        }
+
+        ASSERT_NO_THROW(path.release());
+    }
+}
+
+TEST_F(PathWorldTest, COMPLEX_timeSlicedPath)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    const TerrainGraph& graph = path.getGraph();
+    const Agent agent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    const BT::uint32 budget = 50;
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<PathWorld::WalkTerrainID> randomNode(0, static_cast<PathWorld::WalkTerrainID>(graph.getNbNodes() - 1));
+
+    PathWorld::SearchHandle handle;
+    EXPECT_EQ(PathWorld::SearchStatus::Idle, handle.getStatus());
+
+    PathSearchContext context;
+    std::chrono::steady_clock::duration maxFull(0);
+    std::chrono::steady_clock::duration maxTick(0);
+    size_t nbTicks = 0;
+    size_t nbFound = 0;
+    size_t nbPartial = 0;
+    for(size_t query = 0; query < 50; ++query)
+    {
+        const PathWorld::WalkTerrainID from = randomNode(generator);
+        // Last queries cross sub-graphs (no path)
+        PathWorld::WalkTerrainID to = randomNode(generator);
+        while(query < 40 && graph.getSubgraphID(from) != graph.getSubgraphID(to))
+        {
+            to = randomNode(generator);
+        }
+
+        // Reference: whole search at once
+        auto start = std::chrono::steady_clock::now();
+        const PathWorld::SearchResult full = path.searchPath(agent, from, to, context);
+        maxFull = std::max(maxFull, std::chrono::steady_clock::now() - start);
+        std::vector<BoostPoint> reference;
+        if(full._found)
+        {
+            path.extractPath(to, context, reference);
+        }
+
+        // Same search spread over ticks
+        path.beginPath(agent, from, to, handle);
+        PathWorld::SearchStatus status = handle.getStatus();
+        while(status == PathWorld::SearchStatus::Running)
+        {
+            start = std::chrono::steady_clock::now();
+            status = path.step(handle, budget);
+            maxTick = std::max(maxTick, std::chrono::steady_clock::now() - start);
+            ++nbTicks;
+
+            // Best-so-far path always starts from start node
+            if(status == PathWorld::SearchStatus::Running)
+            {
+                std::vector<BoostPoint> partial;
+                EXPECT_FALSE(path.result(handle, partial));
+                ASSERT_FALSE(partial.empty());
+                EXPECT_TRUE(bg::equals(graph.getCentroid(from), partial.back()));
+                ++nbPartial;
+            }
+        }
+
+        ASSERT_EQ(full._found, status == PathWorld::SearchStatus::Found);
+        EXPECT_EQ(full._nbExpansions, handle.getResult()._nbExpansions);
+        std::vector<BoostPoint> pathWay;
+        EXPECT_EQ(full._found, path.result(handle, pathWay));
+        if(full._found)
+        {
+            ++nbFound;
+            EXPECT_FLOAT_EQ(full._cost, handle.getResult()._cost);
+            ASSERT_EQ(reference.size(), pathWay.size());
+            for(size_t pointID = 0; pointID < pathWay.size(); ++pointID)
+            {
+                EXPECT_TRUE(bg::equals(reference[pointID], pathWay[pointID]));
+            }
+        }
+
+        // Finished search stays finished
+        EXPECT_EQ(status, path.step(handle, budget));
+    }
+
+    std::cout << std::endl << "Time-sliced A* (" << budget << " nodes by tick, " << nbFound << " paths found):" << std::endl;
+    std::cout << "  Longest full query: " << std::chrono::duration_cast<std::chrono::microseconds>(maxFull).count() << " us" << std::endl;
+    std::cout << "  Longest tick:       " << std::chrono::duration_cast<std::chrono::microseconds>(maxTick).count() << " us (" << nbTicks << " ticks)" << std::endl;
+    EXPECT_LT(0u, nbFound);
+    EXPECT_LT(0u, nbPartial);
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_asyncPath)
+{
+    BT::BoundedQueue<size_t> queue(100);
+    EXPECT_EQ(128u, queue.getCapacity());
+
+    // Full then empty
+    size_t item = 0;
+    for(size_t value = 0; value < queue.getCapacity(); ++value)
+    {
+        EXPECT_TRUE(queue.tryPush(size_t(value)));
+    }
+    EXPECT_FALSE(queue.tryPush(size_t(0)));
+    for(size_t value = 0; value < queue.getCapacity(); ++value)
+    {
+        ASSERT_TRUE(queue.tryPop(item));
+        EXPECT_EQ(value, item);
+    }
+    EXPECT_FALSE(queue.tryPop(item));
+
+    // Many producers and consumers: each item is read once
+    const size_t nbItems = 20000;
+    std::atomic<size_t> sum(0);
+    std::atomic<size_t> nbRead(0);
+    std::vector<std::thread> threads;
+    for(size_t producer = 0; producer < 2; ++producer)
+    {
+        threads.emplace_back([&, producer]()
+        {
+            for(size_t value = producer; value < nbItems; value += 2)
+            {
+                while(!queue.tryPush(size_t(value + 1)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(size_t consumer = 0; consumer < 2; ++consumer)
+    {
+        threads.emplace_back([&]()
+        {
+            size_t value = 0;
+            while(nbRead < nbItems)
+            {
+                if(queue.tryPop(value))
+                {
+                    sum += value;
+                    ++nbRead;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(nbItems, nbRead.load());
+    EXPECT_EQ(nbItems * (nbItems + 1) / 2, sum.load());
+
+    // Service on world
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    const TerrainGraph& graph = path.getGraph();
+    const Agent agent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<PathWorld::WalkTerrainID> randomNode(0, static_cast<PathWorld::WalkTerrainID>(graph.getNbNodes() - 1));
+    std::vector<std::pair<PathWorld::WalkTerrainID, PathWorld::WalkTerrainID>> queries;
+    while(queries.size() < 64)
+    {
+        const PathWorld::WalkTerrainID from = randomNode(generator);
+        const PathWorld::WalkTerrainID to   = randomNode(generator);
+        if(graph.getSubgraphID(from) == graph.getSubgraphID(to))
+        {
+            queries.emplace_back(from, to);
+        }
+    }
+
+    {
+        PathService service(path, 2, 128);
+        EXPECT_EQ(2u, service.getNbWorkers());
+
+        // Same paths as synchronous search
+        std::atomic<size_t> nbCallbacks(0);
+        std::vector<PathFuture> futures;
+        for(const auto& query : queries)
+        {
+            futures.push_back(service.submitPath(PathRequest(agent, query.first, query.second), [&](const PathResponse&) { ++nbCallbacks; }));
+        }
+
+        PathSearchContext context;
+        for(size_t queryID = 0; queryID < queries.size(); ++queryID)
+        {
+            std::vector<BoostPoint> reference;
+            const bool found = path.computePath(agent, queries[queryID].first, queries[queryID].second, reference, context);
+
+            const PathResponse& response = futures[queryID].get();
+            EXPECT_TRUE(futures[queryID].isReady());
+            ASSERT_EQ(found ? PathResponse::Status::Found : PathResponse::Status::NotFound, response._status);
+            ASSERT_EQ(reference.size(), response._pathWay.size());
+            for(size_t pointID = 0; pointID < reference.size(); ++pointID)
+            {
+                EXPECT_TRUE(bg::equals(reference[pointID], response._pathWay[pointID]));
+            }
+        }
+        EXPECT_EQ(queries.size(), nbCallbacks.load());
+
+        // Throwing callback: worker stays alive and response is set
+        const PathFuture throwing = service.submitPath(PathRequest(agent, queries[0].first, queries[0].second), [](const PathResponse&) { throw std::runtime_error("callback"); });
+        EXPECT_EQ(PathResponse::Status::Found, throwing.get()._status);
+        EXPECT_EQ(PathResponse::Status::Found, service.submitPath(PathRequest(agent, queries[1].first, queries[1].second)).get()._status);
+
+        // Dropped requests: never computed
+        PathRequest late(agent, queries[0].first, queries[0].second);
+        late._deadline = PathRequest::Clock::now() - std::chrono::milliseconds(1);
+        EXPECT_EQ(PathResponse::Status::Expired, service.submitPath(late).get()._status);
+
+        PathRequest cancelled(agent, queries[0].first, queries[0].second);
+        cancelled._token.cancel();
+        const PathResponse& response = service.submitPath(cancelled).get();
+        EXPECT_EQ(PathResponse::Status::Cancelled, response._status);
+        EXPECT_EQ(0u, response._nbExpansions);
+    }
+
+    // Small queue: producer is never blocked, extra requests are rejected
+    {
+        PathService service(path, 1, 4);
+        CancelToken token;
+        std::vector<PathFuture> futures;
+        for(size_t queryID = 0; queryID < 32; ++queryID)
+        {
+            PathRequest request(agent, queries[queryID].first, queries[queryID].second);
+            request._token = token;
+            futures.push_back(service.submitPath(request));
+        }
+        token.cancel();
+
+        size_t nbRejected = 0;
+        for(const PathFuture& future : futures)
+        {
+            const PathResponse::Status status = future.get()._status;
+            EXPECT_TRUE(status == PathResponse::Status::Rejected || status == PathResponse::Status::Cancelled || status == PathResponse::Status::Found);
+            nbRejected += status == PathResponse::Status::Rejected ? 1 : 0;
+        }
+        EXPECT_LT(0u, nbRejected);
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
+
+TEST_F(PathWorldTest, COMPLEX_pathScheduler)
+{
+    PathWorld path;
+    read(L"map/Map_complex.map", path);
+
+    const TerrainGraph& graph = path.getGraph();
+    const Agent agent({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<PathWorld::WalkTerrainID> randomNode(0, static_cast<PathWorld::WalkTerrainID>(graph.getNbNodes() - 1));
+    std::vector<std::pair<PathWorld::WalkTerrainID, PathWorld::WalkTerrainID>> queries;
+    while(queries.size() < 16)
+    {
+        const PathWorld::WalkTerrainID from = randomNode(generator);
+        const PathWorld::WalkTerrainID to   = randomNode(generator);
+        if(graph.getSubgraphID(from) == graph.getSubgraphID(to))
+        {
+            queries.emplace_back(from, to);
+        }
+    }
+    const auto now = PathRequest::Clock::now();
+
+    // Order: class first, then earliest deadline
+    {
+        PathScheduler scheduler(path, 1);
+        scheduler.pause();
+
+        std::mutex mutex;
+        std::vector<size_t> order;
+        auto record = [&](const size_t queryID) { return [&, queryID](const PathResponse&) { std::lock_guard<std::mutex> lock(mutex); order.push_back(queryID); }; };
+        auto request = [&](const size_t queryID, const std::chrono::seconds delay)
+        {
+            PathRequest result(agent, queries[queryID].first, queries[queryID].second);
+            result._deadline = now + delay;
+            return result;
+        };
+
+        std::vector<PathFuture> futures;
+        futures.push_back(scheduler.submitPath(request(0, std::chrono::seconds(600)), PathScheduler::Priority::Background, record(0)));
+        futures.push_back(scheduler.submitPath(request(1, std::chrono::seconds(500)), PathScheduler::Priority::Normal,     record(1)));
+        futures.push_back(scheduler.submitPath(request(2, std::chrono::seconds(400)), PathScheduler::Priority::Normal,     record(2)));
+        futures.push_back(scheduler.submitPath(request(3, std::chrono::seconds(900)), PathScheduler::Priority::Critical,   record(3)));
+        // Duplicate: same search answers both callers
+        futures.push_back(scheduler.submitPath(request(1, std::chrono::seconds(700)), PathScheduler::Priority::Normal,     record(1)));
+        // Expires while queued: dropped
+        PathRequest late(agent, queries[4].first, queries[4].second);
+        late._deadline = PathRequest::Clock::now() + std::chrono::milliseconds(50);
+        futures.push_back(scheduler.submitPath(late, PathScheduler::Priority::Critical, record(4)));
+
+        PathScheduler::Metrics metrics = scheduler.getMetrics();
+        EXPECT_EQ(2u, metrics._queueDepth[static_cast<size_t>(PathScheduler::Priority::Critical)]);
+        EXPECT_EQ(2u, metrics._queueDepth[static_cast<size_t>(PathScheduler::Priority::Normal)]);
+        EXPECT_EQ(1u, metrics._queueDepth[static_cast<size_t>(PathScheduler::Priority::Background)]);
+        EXPECT_EQ(5u, metrics._maxQueueDepth);
+        EXPECT_EQ(0u, metrics._nbInFlight);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        scheduler.resume();
+        for(const PathFuture& future : futures)
+        {
+            future.get();
+        }
+
+        EXPECT_EQ(PathResponse::Status::Expired, futures[5].get()._status);
+        EXPECT_EQ((std::vector<size_t>{ 4, 3, 2, 1, 1, 0 }), order);
+
+        PathSearchContext context;
+        for(size_t futureID = 0; futureID < 5; ++futureID)
+        {
+            const size_t queryID = futureID == 4 ? 1 : futureID;
+            std::vector<BoostPoint> reference;
+            ASSERT_TRUE(path.computePath(agent, queries[queryID].first, queries[queryID].second, reference, context));
+
+            const PathResponse& response = futures[futureID].get();
+            ASSERT_EQ(PathResponse::Status::Found, response._status);
+            ASSERT_EQ(reference.size(), response._pathWay.size());
+            for(size_t pointID = 0; pointID < reference.size(); ++pointID)
+            {
+                EXPECT_TRUE(bg::equals(reference[pointID], response._pathWay[pointID]));
+            }
+        }
+
+        metrics = scheduler.getMetrics();
+        EXPECT_EQ(6u, metrics._nbSubmitted);
+        EXPECT_EQ(1u, metrics._nbCoalesced);
+        EXPECT_EQ(0u, metrics._nbRejected);
+        EXPECT_EQ(1u, metrics._nbMissedDeadlines);
+        EXPECT_EQ(0u, metrics._nbInFlight);
+        EXPECT_EQ(1u, metrics._nbDispatched[static_cast<size_t>(PathScheduler::Priority::Critical)]);
+        EXPECT_EQ(2u, metrics._nbDispatched[static_cast<size_t>(PathScheduler::Priority::Normal)]);
+        EXPECT_LE(std::chrono::milliseconds(5), metrics._maxWait[static_cast<size_t>(PathScheduler::Priority::Background)]);
+        EXPECT_LE(metrics.getMeanWait(PathScheduler::Priority::Critical), metrics.getMeanWait(PathScheduler::Priority::Background));
+    }
+
+    // Admission control: full class rejects, others still accept
+    {
+        PathScheduler scheduler(path, 2);
+        scheduler.setAdmission(PathScheduler::Priority::Background, 2);
+        scheduler.pause();
+
+        std::vector<PathFuture> futures;
+        for(size_t queryID = 0; queryID < 4; ++queryID)
+        {
+            futures.push_back(scheduler.submitPath(PathRequest(agent, queries[queryID].first, queries[queryID].second), PathScheduler::Priority::Background));
+        }
+        futures.push_back(scheduler.submitPath(PathRequest(agent, queries[5].first, queries[5].second), PathScheduler::Priority::Critical));
+        // Coalesced request takes no room
+        futures.push_back(scheduler.submitPath(PathRequest(agent, queries[0].first, queries[0].second), PathScheduler::Priority::Background));
+
+        EXPECT_TRUE(futures[2].isReady());
+        EXPECT_EQ(PathResponse::Status::Rejected, futures[2].get()._status);
+        EXPECT_EQ(PathResponse::Status::Rejected, futures[3].get()._status);
+
+        PathRequest expired(agent, queries[6].first, queries[6].second);
+        expired._deadline = now - std::chrono::milliseconds(1);
+        EXPECT_EQ(PathResponse::Status::Expired, scheduler.submitPath(expired).get()._status);
+
+        scheduler.resume();
+        EXPECT_EQ(PathResponse::Status::Found, futures[0].get()._status);
+        EXPECT_EQ(PathResponse::Status::Found, futures[1].get()._status);
+        EXPECT_EQ(PathResponse::Status::Found, futures[4].get()._status);
+        EXPECT_EQ(PathResponse::Status::Found, futures[5].get()._status);
+
+        const PathScheduler::Metrics metrics = scheduler.getMetrics();
+        EXPECT_EQ(2u, metrics._nbRejected);
+        EXPECT_EQ(1u, metrics._nbCoalesced);
+        EXPECT_EQ(1u, metrics._nbMissedDeadlines);
+    }
+
+    // Each caller keeps its own token
+    {
+        PathScheduler scheduler(path, 1);
+        scheduler.pause();
+
+        // Cancelled caller is answered alone
+        PathRequest first(agent, queries[0].first, queries[0].second);
+        PathRequest second(agent, queries[0].first, queries[0].second);
+        const PathFuture kept      = scheduler.submitPath(first);
+        const PathFuture cancelled = scheduler.submitPath(second);
+        cancelled.cancel();
+        EXPECT_FALSE(first._token.isCancelled());
+
+        // First caller cancelled: coalesced one is still computed
+        PathRequest third(agent, queries[1].first, queries[1].second);
+        PathRequest fourth(agent, queries[1].first, queries[1].second);
+        const PathFuture firstCancelled = scheduler.submitPath(third);
+        const PathFuture coalesced      = scheduler.submitPath(fourth);
+        firstCancelled.cancel();
+
+        // Token already cancelled: never queued
+        PathRequest before(agent, queries[0].first, queries[0].second);
+        before._token.cancel();
+        const PathFuture refused = scheduler.submitPath(before);
+        EXPECT_TRUE(refused.isReady());
+        EXPECT_EQ(PathResponse::Status::Cancelled, refused.get()._status);
+
+        // All callers cancelled: never computed
+        PathRequest fifth(agent, queries[2].first, queries[2].second);
+        PathRequest sixth(agent, queries[2].first, queries[2].second);
+        const PathFuture abandoned0 = scheduler.submitPath(fifth);
+        const PathFuture abandoned1 = scheduler.submitPath(sixth);
+        abandoned0.cancel();
+        abandoned1.cancel();
+
+        scheduler.resume();
+        EXPECT_EQ(PathResponse::Status::Found,     kept.get()._status);
+        EXPECT_EQ(PathResponse::Status::Cancelled, cancelled.get()._status);
+        EXPECT_EQ(PathResponse::Status::Cancelled, firstCancelled.get()._status);
+        EXPECT_EQ(PathResponse::Status::Found,     coalesced.get()._status);
+        EXPECT_EQ(PathResponse::Status::Cancelled, abandoned0.get()._status);
+        EXPECT_EQ(PathResponse::Status::Cancelled, abandoned1.get()._status);
+
+        const PathScheduler::Metrics metrics = scheduler.getMetrics();
+        EXPECT_EQ(2u, metrics._nbDispatched[static_cast<size_t>(PathScheduler::Priority::Normal)]);
+        EXPECT_EQ(0u, metrics._nbMissedDeadlines);
+    }
+
+    // Running search stops only when all its callers are cancelled
+    {
+        PathScheduler scheduler(path, 1);
+        std::vector<PathFuture> futures;
+        for(size_t callerID = 0; callerID < 3; ++callerID)
+        {
+            futures.push_back(scheduler.submitPath(PathRequest(agent, queries[3].first, queries[3].second)));
+        }
+        futures[0].cancel();
+        futures[1].cancel();
+        EXPECT_EQ(PathResponse::Status::Cancelled, futures[0].get()._status);
+        EXPECT_EQ(PathResponse::Status::Cancelled, futures[1].get()._status);
+        EXPECT_EQ(PathResponse::Status::Found,     futures[2].get()._status);
+    }
+
+    // Units of same profile share search, other profile does not
+    {
+        const Agent sameProfile({ 80.0f, 60.0f, 50.0f, 30.0f, 20.0f, 40.0f, 40.0f });
+        const Agent otherProfile({ 80.0f, 20.0f, 50.0f, 30.0f, 60.0f, 40.0f, 40.0f });
+        PathScheduler scheduler(path, 1);
+        scheduler.pause();
+        const PathFuture first  = scheduler.submitPath(PathRequest(agent, queries[0].first, queries[0].second));
+        const PathFuture second = scheduler.submitPath(PathRequest(sameProfile, queries[0].first, queries[0].second));
+        const PathFuture other  = scheduler.submitPath(PathRequest(otherProfile, queries[0].first, queries[0].second));
+        EXPECT_EQ(1u, scheduler.getMetrics()._nbCoalesced);
+        EXPECT_EQ(2u, scheduler.getMetrics()._queueDepth[static_cast<size_t>(PathScheduler::Priority::Normal)]);
+
+        scheduler.resume();
+        EXPECT_EQ(PathResponse::Status::Found, first.get()._status);
+        EXPECT_EQ(PathResponse::Status::Found, second.get()._status);
+        EXPECT_EQ(PathResponse::Status::Found, other.get()._status);
+        ASSERT_EQ(first.get()._pathWay.size(), second.get()._pathWay.size());
+        for(size_t pointID = 0; pointID < first.get()._pathWay.size(); ++pointID)
+        {
+            EXPECT_TRUE(bg::equals(first.get()._pathWay[pointID], second.get()._pathWay[pointID]));
+        }
+    }
+
+    // Destructor answers pending requests
+    PathFuture pending;
+    {
+        PathScheduler scheduler(path, 1);
+        scheduler.pause();
+        pending = scheduler.submitPath(PathRequest(agent, queries[0].first, queries[0].second));
+    }
+    EXPECT_EQ(PathResponse::Status::Cancelled, pending.get()._status);
+
+    // Many producers: every caller is answered once
+    {
+        PathScheduler scheduler(path, 2);
+        std::atomic<size_t> nbCallbacks(0);
+        std::vector<std::thread> threads;
+        std::vector<std::vector<PathFuture>> futures(4);
+        for(size_t producer = 0; producer < futures.size(); ++producer)
+        {
+            threads.emplace_back([&, producer]()
+            {
+                for(size_t queryID = 0; queryID < queries.size(); ++queryID)
+                {
+                    const auto priority = static_cast<PathScheduler::Priority>((queryID + producer) % PathScheduler::_nbPriorities);
+                    futures[producer].push_back(scheduler.submitPath(PathRequest(agent, queries[queryID].first, queries[queryID].second), priority, [&](const PathResponse&) { ++nbCallbacks; }));
+                }
+            });
+        }
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+        for(const auto& producerFutures : futures)
+        {
+            for(const PathFuture& future : producerFutures)
+            {
+                EXPECT_EQ(PathResponse::Status::Found, future.get()._status);
+            }
+        }
+        EXPECT_EQ(futures.size() * queries.size(), nbCallbacks.load());
+
+        const PathScheduler::Metrics metrics = scheduler.getMetrics();
+        EXPECT_EQ(futures.size() * queries.size(), metrics._nbSubmitted);
+        EXPECT_EQ(0u, metrics._nbInFlight);
+        size_t nbDispatched = 0;
+        for(size_t classID = 0; classID < PathScheduler::_nbPriorities; ++classID)
+        {
+            EXPECT_EQ(0u, metrics._queueDepth[classID]);
+            nbDispatched += metrics._nbDispatched[classID];
+        }
+        EXPECT_EQ(metrics._nbSubmitted, nbDispatched + metrics._nbCoalesced);
+    }
+
+    ASSERT_NO_THROW(path.release());
+}
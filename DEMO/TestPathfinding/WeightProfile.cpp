@@ -0,0 +1,94 @@
+#include "WeightProfile.h"
+
+void WeightProfile::build(const PathWorld& world, const Agent::Navigation& navigation, bool speedMode)
+{
+    BT_PRE_CONDITION(isNull());         // DEV Issue: build() already called !
+    BT_PRE_CONDITION(!world.isNull());  // DEV Issue: World not initialized !
+
+    const TerrainGraph& graph = world.getGraph();
+    const size_t nbNodes = graph.getNbNodes();
+
+    // Same snapshot for all weights
+    const std::shared_ptr<const CostOverlay> overlay = world.getOverlay();
+
+    _navigation        = navigation;
+    _speedMode         = speedMode;
+    _minCostByDistance = world.getMinCostByDistance(navigation, speedMode) * (overlay ? overlay->getMinFactor() : 1.0f);
+    _overlayVersion    = overlay ? overlay->getVersion() : 0;
+    _weights.resize(graph.getNbEdges());
+
+    if(overlay)
+    {
+        const Agent agent(navigation);
+        for(TerrainGraph::NodeID from = 0; from < nbNodes; ++from)
+        {
+            for(TerrainGraph::EdgeID edge = graph.beginEdge(from); edge < graph.endEdge(from); ++edge)
+            {
+                _weights[edge] = speedMode ? world.updateSpeedWeight(edge, *overlay) : world.updateWeight(agent, from, edge, *overlay);
+            }
+        }
+    }
+    else if(speedMode)
+    {
+        for(TerrainGraph::EdgeID edge = 0; edge < _weights.size(); ++edge)
+        {
+            _weights[edge] = world.updateSpeedWeight(edge);
+        }
+    }
+    else
+    {
+        // Checked once here instead of each edge
+        for(const float speed : navigation._speed)
+        {
+            BT_PRE_CONDITION(speed >= 0.0f);
+        }
+        const float* speeds = navigation._speed.data();
+
+        // Same formula as PathWorld::updateWeight() without branch so inner loop can be vectorized
+        for(TerrainGraph::NodeID from = 0; from < nbNodes; ++from)
+        {
+            const float fromSpeed  = speeds[graph.getType(from)];
+            const float fromHeight = graph.getHeight(from);
+            const TerrainGraph::EdgeID endEdge = graph.endEdge(from);
+            for(TerrainGraph::EdgeID edge = graph.beginEdge(from); edge < endEdge; ++edge)
+            {
+                const TerrainGraph::NodeID to = graph.getTarget(edge);
+                const float mean = (fromSpeed + speeds[graph.getType(to)]) * 0.5f;
+                const float diff = std::min(std::max((1000.0f + graph.getHeight(to) - fromHeight) / 1000.0f, 0.5f), 2.0f);
+                _weights[edge] = graph.getDistance(edge) / mean * diff;
+            }
+        }
+    }
+
+    _world = &world;
+
+    BT_POST_CONDITION(!isNull());
+}
+
+void WeightProfile::release()
+{
+    BT_PRE_CONDITION(!isNull());    // DEV Issue: Need to call build before
+
+    _world             = nullptr;
+    _minCostByDistance = 0.0f;
+    _overlayVersion    = 0;
+    _weights           = std::vector<CostType>();
+
+    BT_POST_CONDITION(isNull());
+}
+
+void WeightProfile::setWeight(const TerrainGraph::EdgeID edge, const CostType weight)
+{
+    BT_PRE_CONDITION(!isNull());                // DEV Issue: Need to call build before
+    BT_PRE_CONDITION(edge < _weights.size());   // DEV Issue: Invalid input !
+
+#ifndef NDEBUG
+    // Heuristics using getMinCostByDistance() must stay admissible
+    const TerrainGraph& graph = _world->getGraph();
+    const TerrainGraph::NodeID to   = graph.getTarget(edge);
+    const TerrainGraph::NodeID from = graph.getTarget(graph.getReverseEdge(edge));
+    BT_PRE_CONDITION(weight >= _minCostByDistance * static_cast<CostType>(bg::distance(graph.getCentroid(from), graph.getCentroid(to))) * 0.999f);
+#endif
+
+    _weights[edge] = weight;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "PathWorld.h"
+
+//----------------------------------------------------------------------------
+/// \brief Weight of each edge of PathWorld graph for one agent profile.
+/// Agents share few Navigation profiles: weight is computed once for all
+/// edges so search reads one float by edge instead of calling updateWeight().
+/// \code{ .cpp }
+///     WeightProfile profile;
+///     profile.build(world, agent.getNavigation());
+///     world.computePath(profile, from, to, pathWay, context);
+/// \endcode
+/// \note Weights include cost overlay of world at build(): rebuild profile after overrides.
+class WeightProfile final
+{
+    BT_NOCOPY_NOMOVE(WeightProfile);
+
+    public:
+        using CostType = PathWorld::CostType;
+
+        /// Constructor
+        WeightProfile():
+        _world(nullptr), _speedMode(false), _minCostByDistance(0.0f), _overlayVersion(0)
+        {}
+
+        /// Destructor
+        ~WeightProfile()
+        {
+            BT_POST_CONDITION(isNull());    // DEV Issue: Call release() !
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Compute weight of all edges with current overlay (same value as updateWeight()/updateSpeedWeight()).
+        ///
+        /// \param[in] world: initialized world (must live longer than profile).
+        /// \param[in] navigation: agent profile (speed by terrain).
+        /// \param[in] speedMode: use only distance as weight (navigation is ignored).
+        void build(const PathWorld& world, const Agent::Navigation& navigation, bool speedMode = false);
+
+        //------------------------------------------------------------------------
+        /// \brief  Release all data.
+        ///
+        void release();
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if weights are built.
+        ///
+        /// \returns True if null, false otherwise.
+        bool isNull() const
+        {
+            return _world == nullptr;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if weights were computed for this profile.
+        ///
+        /// \param[in] world: world to search.
+        /// \param[in] navigation: agent profile.
+        /// \param[in] speedMode: use only distance as weight.
+        /// \returns True if compatible, false otherwise.
+        bool isCompatible(const PathWorld& world, const Agent::Navigation& navigation, bool speedMode) const
+        {
+            return _world == &world && _speedMode == speedMode && (speedMode || _navigation._speed == navigation._speed);
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get world used to build weights.
+        ///
+        /// \returns World.
+        const PathWorld& getWorld() const
+        {
+            BT_PRE_CONDITION(!isNull());
+            return *_world;
+        }
+
+        bool isSpeedMode() const
+        {
+            return _speedMode;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Check if weights were computed with current overlay of world.
+        ///
+        /// \returns True if up to date, false if overlay changed since build().
+        bool isUpToDate() const
+        {
+            BT_PRE_CONDITION(!isNull());
+            return _overlayVersion == _world->getOverlayVersion();
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get lowest weight by unit of straight distance (see PathWorld::getMinCostByDistance()).
+        ///
+        /// \returns Factor of admissible heuristic.
+        CostType getMinCostByDistance() const
+        {
+            return _minCostByDistance;
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Get weight of edge.
+        ///
+        /// \param[in] edge: edge of world graph.
+        /// \returns Weight of edge.
+        CostType getWeight(const TerrainGraph::EdgeID edge) const
+        {
+            BT_PRE_CONDITION(edge < _weights.size());
+            return _weights[edge];
+        }
+
+        //------------------------------------------------------------------------
+        /// \brief  Change weight of edge (terrain changed at runtime).
+        /// \note Never call during a search reading this profile.
+        ///
+        /// \param[in] edge: edge of world graph.
+        /// \param[in] weight: new weight (infinity = blocked), never under admissible bound (see getMinCostByDistance()).
+        void setWeight(const TerrainGraph::EdgeID edge, const CostType weight);
+
+    private:
+        const PathWorld*        _world;             ///< [LINK] Source world. WARNING: No destruction.
+        Agent::Navigation       _navigation;        ///< Profile used for weights.
+        bool                    _speedMode;         ///< Distance only weight.
+        CostType                _minCostByDistance; ///< Heuristic factor of profile.
+        CostOverlay::Version    _overlayVersion;    ///< Overlay used by build().
+
+        std::vector<CostType>   _weights;           ///< [OWNERSHIP] Weight of each edge.
+};